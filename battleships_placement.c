@@ -3,113 +3,82 @@
  * DATE: 16/10/2018
  * DESCRIPTION: A series of helper functions to assist with a 
  * battleships placement implementation. Specifically handles ship 
- * rotation, updating ship position after a navswitch push, and 
- * recording an int matrix into a normal matrix.
+ * rotation and updating ship position after a navswitch push.
  */
 
 
+#include "battleships_placement.h"
 #include "cursor.h"
-#include "button.h"
+#include "input.h"
 #include <stdbool.h>
 
-#define HORIZONTAL 0
-#define VERTICAL 1
 
 
-
-uint8_t shipMatrix[ROWS_NUM][COLS_NUM] = {{0, 0, 0, 0, 0},
-										  {0, 0, 0, 0, 0},
-										  {0, 0, 0, 0, 0},
-										  {0, 0, 0, 0, 0},
-										  {0, 0, 0, 0, 0},
-										  {0, 0, 0, 0, 0},
-										  {0, 0, 0, 0, 0}};
+static int wrap(int value, int modNum)
+/* Returns value modulus modNum, in the range 0 to modNum-1 even when 
+ * value is negative. */
+{
+	value %= modNum;
+	return value < 0 ? value + modNum : value;
+}
 
 
 
-void updateShipPosition (uint8_t cursorMatrix[], Cursor* shipCursor) 
-/* Updates the position of the ship the player is placing given what 
- * navswitch buttons the player has pressed. */
+uint8_t shipColumn(const Ship* ship, int column)
+/* Returns the int matrix column (see int_matrix.h) of the ship at the 
+ * given column, i.e one bit set for each row of that column the ship 
+ * covers. */
 {
-	updateMatrixPosition(cursorMatrix, shipCursor) ;
+	int half = ship->length / 2;
+	int firstRow = 0;
+	uint8_t rows = 0;
+	
+	if (ship->direction == HORIZONTAL) {
+		/* Covers length columns from the one half to the left of the centre */
+		if (wrap(column - ship->centre.column + half, COLS_NUM) < ship->length) {
+			return 1 << ship->centre.row;
+		}
+		return 0;
+	}
+	
+	if (column != ship->centre.column) {
+		return 0;
+	}
+	/* Covers length rows from the one half above the centre, rotated so 
+	 * that rows that run off the bottom come back at the top */
+	rows = (1 << ship->length) - 1;
+	firstRow = wrap(ship->centre.row - half, ROWS_NUM);
+	return ((rows << firstRow) | (rows >> (ROWS_NUM - firstRow))) & MAX_ROW_NUM;
 }
 
 
 
-void recordMatrix (const uint8_t shipPositionsIntMatrix[], int numRows, int numCols)
-/* Records/copies a given int matrix into the global variable shipMatrix */
+void shipToIntMatrix(const Ship* ship, uint8_t intMatrix[])
+/* Writes the ship into intMatrix, which has COLS_NUM columns. */
 {
-	int row = 0;
-	int col = 0;
-	for (row=numRows-1; row >= 0; row--) {
-		for (col=0; col < numCols; col++) {
-			shipMatrix[row][col] = (shipPositionsIntMatrix[col] >> row) & 1;
-		}
+	int column = 0;
+	for (column = 0; column < COLS_NUM; column++) {
+		intMatrix[column] = shipColumn(ship, column);
 	}
 }
 
 
 
-bool isRotateAllowed(const uint8_t cursorMatrix[], int shipDirection)
-/* Check if a rotate is legal at the current ship position. Return true 
- * if legal, else false.*/
+void updateShipPosition (Ship* ship, uint8_t event) 
+/* Updates the position of the ship the player is placing given an 
+ * input event (see input.h). */
 {
-	if (shipDirection == HORIZONTAL) {	
-		if ((cursorMatrix[0] & cursorMatrix[COLS_NUM-1])) {
-			return false;
-		}
-	} 
-	return true;
+	updateCursorPosition(&ship->centre, event);
 }
 
 
 
-void updateShipRotation(uint8_t cursorIntMatrix[], int boatLength, Cursor* shipCursor) 
-/* Checks to see if the player has pressed the white button to rotate 
- * the ship. If they have, then this function rotates the ship in the 
- * cursorIntMatrix by 90 degrees if the rotation is legal.*/
+void updateShipRotation(Ship* ship, uint8_t event) 
+/* Checks to see if the input event is the player pressing the white 
+ * button to rotate the ship. If it is, then this function rotates the 
+ * ship by 90 degrees about its centre. */
 {
-	int columnNum = 0;
-	int bit = 0;
-	int column = 0;
-	static int shipDirection = HORIZONTAL;
-	
-	if (button_push_event_p(0) && boatLength != 1) {
-		if (isRotateAllowed(cursorIntMatrix, shipDirection)) {
-			if (shipDirection == HORIZONTAL) {
-				columnNum = 0;
-				/* For each column, take the shipHull->row-th bit (the bit on the row we are currently at) and put it into columnNum */
-				for (column = 0; column < LEDMAT_COLS_NUM; column++) {
-					bit = cursorIntMatrix[column] >> shipCursor->row;
-					columnNum += bit;
-					columnNum <<= 1;
-					cursorIntMatrix[column] = 0;
-				}
-				columnNum >>= 1;
-				/* Get rid of any leading 0s */
-				while (!(columnNum & 1)) {
-					columnNum >>= 1;
-				}
-				/* Add the proper amount of leading 0s given the row we are on */
-				columnNum <<= (shipCursor->row - 1);
-				if (columnNum > MAX_ROW_NUM) {
-					columnNum &= ~(1 << LEDMAT_ROWS_NUM); /* Clear the overflow bit */
-					columnNum |= 1; /* Add the overflow bit to the top of the screen */
-				}
-				cursorIntMatrix[shipCursor->column] = columnNum;
-				shipDirection = VERTICAL;
-				
-				
-			} else if (shipDirection == VERTICAL) {
-				clearIntMatrix(cursorIntMatrix, LEDMAT_COLS_NUM);
-				/* Put the boat on the screen in horizontal position */
-				for (column=0; column < boatLength; column++) {
-					cursorIntMatrix[column] = (1 << shipCursor->row);
-				}
-				/* Move the boat into the correct position */
-				moveColsToRight(cursorIntMatrix, LEDMAT_COLS_NUM, shipCursor->column - 1);
-				shipDirection = HORIZONTAL;
-			}
-		}
-	}	
+	if (event == INPUT_BUTTON && ship->length != 1) {
+		ship->direction = ship->direction == HORIZONTAL ? VERTICAL : HORIZONTAL;
+	}
 }
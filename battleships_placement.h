@@ -3,15 +3,14 @@
  * DATE: 16/10/2018
  * DESCRIPTION: A series of helper functions to assist with a 
  * battleships placement implementation. Specifically handles ship 
- * rotation, updating ship position after a navswitch push, and 
- * recording an int matrix into a normal matrix.
+ * rotation and updating ship position after a navswitch push.
  */
 
 #ifndef BATTLESHIPS_PLACEMENT
 #define BATTLESHIPS_PLACEMENT
 
 #include "cursor.h"
-#include "button.h"
+#include "input.h"
 #include <stdbool.h>
 
 #define HORIZONTAL 0
@@ -19,31 +18,42 @@
 
 
 
-uint8_t shipMatrix[ROWS_NUM][COLS_NUM];
+/* A ship, stored as its shape and where it is rather than as an int
+ * matrix. Moving or rotating a ship only changes a field, and its int
+ * matrix is worked out when it is needed. Ships wrap around the edges
+ * of the screen. */
+typedef struct ship_s
+{
+    int length;
+    int direction;  /* HORIZONTAL or VERTICAL */
+    Cursor centre;  /* The middle of the ship */
 
+} Ship;
 
 
-void updateShipPosition (uint8_t cursorMatrix[], Cursor* shipCursor);
-/* Updates the position of the ship the player is placing given what 
- * navswitch buttons the player has pressed. */
 
+uint8_t shipColumn(const Ship* ship, int column);
+/* Returns the int matrix column (see int_matrix.h) of the ship at the 
+ * given column, i.e one bit set for each row of that column the ship 
+ * covers. */
 
 
-void recordMatrix (const uint8_t shipPositionsIntMatrix[], int numRows, int numCols);
-/* Records/copies a given int matrix into the global variable shipMatrix */
 
+void shipToIntMatrix(const Ship* ship, uint8_t intMatrix[]);
+/* Writes the ship into intMatrix, which has COLS_NUM columns. */
 
 
-bool isRotateAllowed(const uint8_t cursorMatrix[], int shipDirection);
-/* Check if a rotate is legal at the current ship position. Return true 
- * if legal, else false.*/
 
+void updateShipPosition (Ship* ship, uint8_t event);
+/* Updates the position of the ship the player is placing given an 
+ * input event (see input.h). */
 
 
-void updateShipRotation(uint8_t cursorIntMatrix[], int boatLength, Cursor* shipCursor);
-/* Checks to see if the player has pressed the white button to rotate 
- * the ship. If they have, then this function rotates the ship in the 
- * cursorIntMatrix by 90 degrees if the rotation is legal.*/
+
+void updateShipRotation(Ship* ship, uint8_t event);
+/* Checks to see if the input event is the player pressing the white 
+ * button to rotate the ship. If it is, then this function rotates the 
+ * ship by 90 degrees about its centre. */
 
 
 #endif /* BATTLESHIPS_PLACEMENT */
@@ -0,0 +1,300 @@
+/** FILE: candidates.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Keeps track of where the opponent's ships could still
+ * be. See candidates.h.
+ */
+
+#include "candidates.h"
+
+/* Only needed for the target overlay, so nothing is built without it */
+#if TARGET_OVERLAY
+
+#include <string.h>
+
+#if CANDIDATES_LONG_LENGTH != 3
+#error "candidates.c only handles a long ship of 3 cells, centred on its middle cell"
+#endif
+
+/* Number of centres, and so of placements in each direction */
+#define NUM_CELLS (COLS_NUM * ROWS_NUM)
+#define NUM_PLACEMENTS (2 * NUM_CELLS)
+
+/* The value of next when there is no overlay being worked out */
+#define STEP_DONE 0xff
+
+
+
+static uint8_t leftOf(uint8_t column)
+/* Returns the column to the left of column, wrapping around. */
+{
+    return column == 0 ? COLS_NUM - 1 : column - 1;
+}
+
+
+
+static uint8_t rightOf(uint8_t column)
+/* Returns the column to the right of column, wrapping around. */
+{
+    return column == COLS_NUM - 1 ? 0 : column + 1;
+}
+
+
+
+static uint8_t verticalRows(uint8_t row)
+/* Returns the rows covered by a vertical long ship centred on row, as
+ * an int matrix column. This is also the set of centres of vertical
+ * long ships that cover row. */
+{
+    uint8_t first = row == 0 ? ROWS_NUM - 1 : row - 1;
+    uint8_t rows = (1 << CANDIDATES_LONG_LENGTH) - 1;
+
+    return ((rows << first) | (rows >> (ROWS_NUM - first))) & MAX_ROW_NUM;
+}
+
+
+
+static uint8_t countBits(uint8_t bits)
+/* Returns the number of bits set. */
+{
+    uint8_t count = 0;
+
+    for (; bits != 0; bits &= bits - 1) {
+        count++;
+    }
+    return count;
+}
+
+
+
+static void overlayRestart(Candidates* candidates)
+/* Starts working out the overlay again. */
+{
+    memset(candidates->pending, 0, COLS_NUM);
+    candidates->next = 0;
+}
+
+
+
+static void fullyHit(const uint8_t hitMatrix[], const uint8_t cells[], uint8_t horizontal[], uint8_t vertical[])
+/* Sets the centres of the long ship placements that cover any of cells
+ * and have been hit in every cell. */
+{
+    uint8_t column = 0;
+    uint8_t row = 0;
+    uint8_t rowNum = 0;
+    uint8_t centre = 0;
+    uint8_t rows = 0;
+
+    memset(horizontal, 0, COLS_NUM);
+    memset(vertical, 0, COLS_NUM);
+    for (column = 0; column < COLS_NUM; column++) {
+        for (row = 0; row < ROWS_NUM; row++) {
+            rowNum = 1 << row;
+            if (!(cells[column] & rowNum)) {
+                continue;
+            }
+            /* Horizontal ships centred on this row one column either side */
+            centre = leftOf(column);
+            if (hitMatrix[leftOf(centre)] & hitMatrix[centre] & hitMatrix[rightOf(centre)] & rowNum) {
+                horizontal[centre] |= rowNum;
+            }
+            if (hitMatrix[leftOf(column)] & hitMatrix[column] & hitMatrix[rightOf(column)] & rowNum) {
+                horizontal[column] |= rowNum;
+            }
+            centre = rightOf(column);
+            if (hitMatrix[leftOf(centre)] & hitMatrix[centre] & hitMatrix[rightOf(centre)] & rowNum) {
+                horizontal[centre] |= rowNum;
+            }
+            /* Vertical ships in this column centred one row either side */
+            for (centre = 0; centre < ROWS_NUM; centre++) {
+                rows = verticalRows(centre);
+                if ((verticalRows(row) & (1 << centre)) && (hitMatrix[column] & rows) == rows) {
+                    vertical[column] |= 1 << centre;
+                }
+            }
+        }
+    }
+}
+
+
+
+void candidatesRebuild(Candidates* candidates, const uint8_t hitMatrix[], const uint8_t missMatrix[], uint8_t sunk)
+/* Works out the placements from scratch from all the shots so far,
+ * e.g when a match is resumed. sunk has bit CANDIDATES_*_SHIP set for
+ * each ship that is sunk. With empty boards every placement is
+ * possible. */
+{
+    uint8_t hitHorizontal[COLS_NUM];
+    uint8_t hitVertical[COLS_NUM];
+    uint8_t column = 0;
+    uint8_t row = 0;
+
+    memset(candidates->horizontal, MAX_ROW_NUM, COLS_NUM);
+    memset(candidates->vertical, MAX_ROW_NUM, COLS_NUM);
+    memset(candidates->single, MAX_ROW_NUM, COLS_NUM);
+    memset(candidates->overlay, 0, COLS_NUM);
+
+    for (column = 0; column < COLS_NUM; column++) {
+        for (row = 0; row < ROWS_NUM; row++) {
+            /* A cell shot at again after it was hit is also a miss */
+            if ((missMatrix[column] & ~hitMatrix[column]) & (1 << row)) {
+                candidatesMiss(candidates, column, row);
+            }
+        }
+    }
+
+    fullyHit(hitMatrix, hitMatrix, hitHorizontal, hitVertical);
+    for (column = 0; column < COLS_NUM; column++) {
+        if (sunk & (1 << CANDIDATES_SHORT_SHIP)) {
+            candidates->single[column] &= hitMatrix[column];
+        } else {
+            candidates->single[column] &= ~hitMatrix[column];
+        }
+        if (sunk & (1 << CANDIDATES_LONG_SHIP)) {
+            candidates->horizontal[column] &= hitHorizontal[column];
+            candidates->vertical[column] &= hitVertical[column];
+        } else {
+            candidates->horizontal[column] &= ~hitHorizontal[column];
+            candidates->vertical[column] &= ~hitVertical[column];
+        }
+    }
+    overlayRestart(candidates);
+}
+
+
+
+void candidatesMiss(Candidates* candidates, uint8_t column, uint8_t row)
+/* Removes the placements that cover a cell that was missed. */
+{
+    uint8_t rowNum = 1 << row;
+
+    candidates->single[column] &= ~rowNum;
+    candidates->horizontal[leftOf(column)] &= ~rowNum;
+    candidates->horizontal[column] &= ~rowNum;
+    candidates->horizontal[rightOf(column)] &= ~rowNum;
+    candidates->vertical[column] &= ~verticalRows(row);
+    candidates->overlay[column] &= ~rowNum;
+}
+
+
+
+void candidatesTurn(Candidates* candidates, const uint8_t hitMatrix[], const uint8_t turnHits[], uint8_t sunk, uint8_t newlySunk)
+/* Updates the placements once the hits of a turn (turnHits, also in
+ * hitMatrix) are known. sunk has a bit set for each ship sunk so far,
+ * and newlySunk for each ship sunk this turn. Starts a new overlay. */
+{
+    uint8_t hitHorizontal[COLS_NUM];
+    uint8_t hitVertical[COLS_NUM];
+    uint8_t column = 0;
+
+    /* Only placements covering this turn's hits can have changed */
+    fullyHit(hitMatrix, turnHits, hitHorizontal, hitVertical);
+    for (column = 0; column < COLS_NUM; column++) {
+        /* The short ship sinks when it is hit, so it was hit this turn
+         * if it sank and has never been hit if it is afloat */
+        if (newlySunk & (1 << CANDIDATES_SHORT_SHIP)) {
+            candidates->single[column] &= turnHits[column];
+        } else if (!(sunk & (1 << CANDIDATES_SHORT_SHIP))) {
+            candidates->single[column] &= ~turnHits[column];
+        }
+        /* The long ship sank this turn if it is now hit in every cell */
+        if (newlySunk & (1 << CANDIDATES_LONG_SHIP)) {
+            candidates->horizontal[column] &= hitHorizontal[column];
+            candidates->vertical[column] &= hitVertical[column];
+        } else if (!(sunk & (1 << CANDIDATES_LONG_SHIP))) {
+            candidates->horizontal[column] &= ~hitHorizontal[column];
+            candidates->vertical[column] &= ~hitVertical[column];
+        }
+        candidates->overlay[column] &= ~turnHits[column];
+    }
+    overlayRestart(candidates);
+}
+
+
+
+bool candidatesStep(Candidates* candidates, const uint8_t hitMatrix[], const uint8_t missMatrix[])
+/* Checks the next CANDIDATES_PER_STEP long ship placements against the
+ * short ship ones. Returns true if this finished the overlay, which is
+ * then copied into candidates->overlay. */
+{
+    uint8_t ship[COLS_NUM];
+    uint8_t numHits = 0;
+    uint8_t shipHits = 0;
+    uint8_t column = 0;
+    uint8_t row = 0;
+    uint8_t rowNum = 0;
+    uint8_t cell = 0;
+    uint8_t step = 0;
+    uint8_t other = COLS_NUM;
+    uint8_t spare = 0;
+
+    if (candidates->next == STEP_DONE) {
+        return false;
+    }
+    for (column = 0; column < COLS_NUM; column++) {
+        numHits += countBits(hitMatrix[column]);
+    }
+
+    for (step = 0; step < CANDIDATES_PER_STEP && candidates->next < NUM_PLACEMENTS; step++) {
+        cell = candidates->next % NUM_CELLS;
+        column = cell / ROWS_NUM;
+        row = cell % ROWS_NUM;
+        rowNum = 1 << row;
+        memset(ship, 0, COLS_NUM);
+        if (candidates->next < NUM_CELLS) {
+            if (!(candidates->horizontal[column] & rowNum)) {
+                candidates->next++;
+                continue;
+            }
+            ship[leftOf(column)] = rowNum;
+            ship[column] = rowNum;
+            ship[rightOf(column)] = rowNum;
+        } else {
+            if (!(candidates->vertical[column] & rowNum)) {
+                candidates->next++;
+                continue;
+            }
+            ship[column] = verticalRows(row);
+        }
+        candidates->next++;
+
+        /* Every hit must be on one of the two ships, so at most one can
+         * be outside the long ship and it must be the short ship */
+        shipHits = 0;
+        other = COLS_NUM;
+        for (column = 0; column < COLS_NUM; column++) {
+            shipHits += countBits(hitMatrix[column] & ship[column]);
+            if (hitMatrix[column] & ~ship[column]) {
+                other = column;
+            }
+        }
+        if (shipHits == numHits) {
+            /* The short ship can be anywhere it could be that is not
+             * under this one, if there is such a place */
+            spare = 0;
+            for (column = 0; column < COLS_NUM; column++) {
+                spare |= candidates->single[column] & ~ship[column];
+            }
+            for (column = 0; column < COLS_NUM && spare != 0; column++) {
+                candidates->pending[column] |= ship[column] | (candidates->single[column] & ~ship[column]);
+            }
+        } else if (shipHits + 1 == numHits && (candidates->single[other] & hitMatrix[other] & ~ship[other])) {
+            for (column = 0; column < COLS_NUM; column++) {
+                candidates->pending[column] |= ship[column];
+            }
+            candidates->pending[other] |= hitMatrix[other] & ~ship[other];
+        }
+    }
+
+    if (candidates->next < NUM_PLACEMENTS) {
+        return false;
+    }
+    for (column = 0; column < COLS_NUM; column++) {
+        candidates->overlay[column] = candidates->pending[column] & ~hitMatrix[column] & ~missMatrix[column];
+    }
+    candidates->next = STEP_DONE;
+    return true;
+}
+
+#endif /* TARGET_OVERLAY */
@@ -0,0 +1,80 @@
+/** FILE: candidates.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Keeps track of where the opponent's ships could still
+ * be, given where our shots have hit and missed and which ships the
+ * opponent has said are sunk. The opponent's fleet is one ship of
+ * CANDIDATES_LONG_LENGTH cells, which can be horizontal or vertical,
+ * and one ship of one cell. Ships wrap around the edges of the screen
+ * (see battleships_placement.h), so every cell can be the centre of
+ * either ship: 70 placements of the long ship and 35 of the short one.
+ *
+ * The placements are kept as int matrices (see int_matrix.h), with a
+ * bit set for each centre that is still possible. They are updated
+ * after each shot, looking only at the few placements that cover the
+ * cells shot at. Which cells could still hold a ship (the overlay)
+ * depends on both ships together, so it is worked out a few placements
+ * at a time by candidatesStep, which is called once per tick.
+ *
+ * Only the target overlay uses this, so candidates.c is empty unless
+ * the game is built with make TARGET_OVERLAY=1.
+ */
+
+
+#ifndef CANDIDATES_H
+#define CANDIDATES_H
+
+#include "cursor.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CANDIDATES_LONG_LENGTH 3
+
+/* The index of each ship in sunk bit masks, in the order they are placed */
+#define CANDIDATES_LONG_SHIP 0
+#define CANDIDATES_SHORT_SHIP 1
+
+/* Long ship placements checked by each call to candidatesStep */
+#define CANDIDATES_PER_STEP 10
+
+
+
+typedef struct candidates_s
+{
+    uint8_t horizontal[COLS_NUM];   /* Centres of the long ship lying horizontally */
+    uint8_t vertical[COLS_NUM];     /* Centres of the long ship standing vertically */
+    uint8_t single[COLS_NUM];       /* Where the short ship could be */
+    uint8_t overlay[COLS_NUM];      /* Cells not shot at that could still hold a ship */
+    uint8_t pending[COLS_NUM];      /* The overlay being worked out by candidatesStep */
+    uint8_t next;                   /* The next long ship placement for candidatesStep */
+
+} Candidates;
+
+
+
+void candidatesRebuild(Candidates* candidates, const uint8_t hitMatrix[], const uint8_t missMatrix[], uint8_t sunk);
+/* Works out the placements from scratch from all the shots so far,
+ * e.g when a match is resumed. sunk has bit CANDIDATES_*_SHIP set for
+ * each ship that is sunk. With empty boards every placement is
+ * possible. */
+
+
+
+void candidatesMiss(Candidates* candidates, uint8_t column, uint8_t row);
+/* Removes the placements that cover a cell that was missed. */
+
+
+
+void candidatesTurn(Candidates* candidates, const uint8_t hitMatrix[], const uint8_t turnHits[], uint8_t sunk, uint8_t newlySunk);
+/* Updates the placements once the hits of a turn (turnHits, also in
+ * hitMatrix) are known. sunk has a bit set for each ship sunk so far,
+ * and newlySunk for each ship sunk this turn. Starts a new overlay. */
+
+
+
+bool candidatesStep(Candidates* candidates, const uint8_t hitMatrix[], const uint8_t missMatrix[]);
+/* Checks the next CANDIDATES_PER_STEP long ship placements against the
+ * short ship ones. Returns true if this finished the overlay, which is
+ * then copied into candidates->overlay. */
+
+#endif /* CANDIDATES_H */
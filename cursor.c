@@ -8,7 +8,7 @@
 
 #include "cursor.h"
 #include "int_matrix.h"
-#include "navswitch.h"
+#include "input.h"
 #include "system.h"
  
 #define MAX_ROW_NUM 0x7f
@@ -29,19 +29,18 @@ static void simpleMod(int* variable, int modNum)
 
 
 
-void updateCursorPosition(Cursor* cursor)
-/* Updates the cursor position by checking to see if the navswitch
-* has been pushed and updates cursor position accordingly (i.e pushing
-* navswitch NORTH moves cursor up etc.) */
+void updateCursorPosition(Cursor* cursor, uint8_t event)
+/* Updates the cursor position given an input event (see input.h),
+* i.e pushing the navswitch NORTH moves the cursor up etc. */
 {
-	if (navswitch_push_event_p (NAVSWITCH_EAST)) {
+	if (event == INPUT_EAST) {
 		cursor->column++;
-	} else if (navswitch_push_event_p (NAVSWITCH_WEST)) {
+	} else if (event == INPUT_WEST) {
 		cursor->column--;
-	} else if (navswitch_push_event_p (NAVSWITCH_NORTH)) {
+	} else if (event == INPUT_NORTH) {
 		cursor->rowNum >>= 1;
 		cursor->row--;
-	} else if (navswitch_push_event_p (NAVSWITCH_SOUTH)) {
+	} else if (event == INPUT_SOUTH) {
 		cursor->rowNum <<= 1;
 		cursor->row++;
 	}
@@ -55,39 +54,3 @@ void updateCursorPosition(Cursor* cursor)
 	simpleMod(&cursor->row, ROWS_NUM);
 	simpleMod(&cursor->column, COLS_NUM);
 }
- 
- 
- 
-void updateMatrixPosition(uint8_t cursorMatrix[], Cursor* cursor) 
-/* Similar to updateCursorPosition but instead of moving only the cursor,
- * moves the entire matrix as well. Ideal to use if the cursor is 
- * tracking the centre of a large object on the screen. */
-{
-	if (navswitch_push_event_p(NAVSWITCH_NORTH)) {
-		moveRowsUp(cursorMatrix, ROWS_NUM, COLS_NUM, 1);
-		cursor->rowNum >>= 1;
-		cursor->row--;
-			
-	} else if (navswitch_push_event_p(NAVSWITCH_SOUTH)) {
-		moveRowsDown(cursorMatrix, MAX_ROW_NUM, COLS_NUM, ROWS_NUM, 1);
-		cursor->rowNum <<= 1;
-		cursor->row++;
-			
-	} else if (navswitch_push_event_p(NAVSWITCH_WEST)) {
-		moveColsToLeft(cursorMatrix, COLS_NUM, 1);
-		cursor->column--;
-			
-	} else if (navswitch_push_event_p(NAVSWITCH_EAST)) {
-		moveColsToRight(cursorMatrix, COLS_NUM, 1);
-		cursor->column++;
-	}
-	
-	//Stops the cursor from running off the top, bottom, and sides
-	if (cursor->rowNum > MAX_ROW_NUM) {
-        cursor->rowNum = 0x01;
-    } else if (cursor->rowNum < MIN_ROW_NUM) {
-        cursor->rowNum = (1 << (ROWS_NUM-1));
-    }
-	simpleMod(&cursor->row, ROWS_NUM);
-	simpleMod(&cursor->column, COLS_NUM);
-}
@@ -10,7 +10,7 @@
 #define CURSOR_H
 
 #include "int_matrix.h"
-#include "navswitch.h"
+#include "input.h"
 #include "system.h"
  
 #define MAX_ROW_NUM 0x7f
@@ -30,16 +30,8 @@ typedef struct cursor_s
  
  
  
-void updateCursorPosition(Cursor* cursor);
-/* Updates the cursor position by checking to see if the navswitch
-* has been pushed and updates cursor position accordingly (i.e pushing
-* navswitch NORTH moves cursor up etc.) */
-
-
-
-void updateMatrixPosition(uint8_t cursorMatrix[], Cursor* cursor);
-/* Similar to updateCursorPosition but instead of moving only the cursor,
- * moves the entire matrix as well. Ideal to use if the cursor is 
- * tracking the centre of a large object on the screen. */
+void updateCursorPosition(Cursor* cursor, uint8_t event);
+/* Updates the cursor position given an input event (see input.h),
+* i.e pushing the navswitch NORTH moves the cursor up etc. */
 
 #endif /* CURSOR_H */
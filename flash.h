@@ -0,0 +1,24 @@
+/** FILE: flash.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Access to constant data kept in program memory. When
+ * built for the host (see music_render.c) the data is kept in ordinary
+ * memory instead.
+ */
+
+
+#ifndef FLASH_H
+#define FLASH_H
+
+#include <stdint.h>
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#else
+#define PROGMEM
+#define pgm_read_byte(ADDRESS) (*(const uint8_t*) (ADDRESS))
+#define pgm_read_word(ADDRESS) (*(const uint16_t*) (ADDRESS))
+#define pgm_read_ptr(ADDRESS) (*(void* const*) (ADDRESS))
+#endif
+
+#endif /* FLASH_H */
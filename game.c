@@ -8,21 +8,30 @@
 
 #include "system.h"
 #include "task.h"
+#include "timer.h"
 #include "ledmat.h"
 #include "pacer.h"
-#include "navswitch.h"
-#include "button.h"
+#include "input.h"
 #include "tinygl.h"
-#include "../fonts/font5x7_1.h"
-#include "ir_uart.h"
+#include "font5x7_1.h"
+#include "link.h"
 #include "tinygl.h"
 #include "cursor.h"
 #include "music.h"
 #include "battleships_placement.h"
+#include "phase.h"
+#include "mem_usage.h"
+#include "profile.h"
+#include "trace.h"
+#include "flash.h"
+#include "snapshot.h"
+#include "idle.h"
+#include "candidates.h"
 #include <avr/io.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 /* Task scheduler constants */
 #define LOOP_RATE 250
@@ -30,14 +39,99 @@
 #define COMMUNICATION_RATE 100
 #define NUM_TASKS 4
 
+/* The index of playLoop in the task table */
+#define PLAY_TASK 0
+
+/* Seconds without input in the waiting phase before the display is 
+ * turned off to save power, 0 to leave it on */
+#define IDLE_DISPLAY_TIMEOUT 30
+
 #define MAX_NUM_HITS 4
 
+/* Game phases, these index phaseTable */
+#define PHASE_PLACEMENT 0
+#define PHASE_FIRE 1
+#define PHASE_WAITING 2
+#define PHASE_END 3
+#define PHASE_RESYNC 4
+
+#if SNAPSHOT_COLS != COLS_NUM || SNAPSHOT_ROWS != ROWS_NUM
+#error "snapshot.h does not match the size of the LED matrix"
+#endif
+
+/* While resuming, each board sends RESYNC_BYTE plus a 5-bit hash of
+ * the match (in the bits outside RESYNC_MASK) this many times a second
+ * until it hears the other one. These bytes are 0x08 to 0x3f with bit 3
+ * set: never a shot (the column is at most 5), a reply ('H', 'M', 
+ * SUNK_REPLY + s or SALVO_REPLY + bits), REMATCH_BYTE, REMATCH_ANSWER or
+ * a salvo header. */
+#define RESYNC_RATE 10
+#define RESYNC_BYTE 0x08
+#define RESYNC_MASK 0xc8
+
+/* Sent from the end screen to ask for a rematch, and answered with 
+ * REMATCH_ANSWER by a board that has already started the rematch. A 
+ * board only answers REMATCH_BYTE, so two boards that have both started
+ * never keep answering each other. Neither is ever a valid shot. */
+#define REMATCH_BYTE 0x7f
+#define REMATCH_ANSWER 0x7e
+#define REMATCH_RATE 10
+
 #define DEFAULT_COL 2
 #define DEFAULT_ROW 3
 
 /* Specifies how many bits in an 8-bit message should be allocated to the 
  * column number. The remaining bits are allocated by default to the row number */
 #define COL_BITS 4
+#define COL_MASK ((1 << COL_BITS) - 1)
+
+/* The ships of each fleet, in the order they are placed (see 
+ * candidates.h) */
+#define NUM_SHIPS 2
+
+/* Number of shots fired per turn, set with make SALVO_SHOTS=n (at most
+ * 5, and both boards must agree). With 1 shot each turn sends one 
+ * position byte and gets 'H' or 'M' back, or SUNK_REPLY + s if the 
+ * shot sank ship s. With more, the shots are sent as one frame 
+ * (SALVO_HEADER + n, then n position bytes) and the reply is 
+ * SALVO_REPLY with bit i set if shot i hit and bit n + s set if ship s
+ * sank.
+ *
+ * To measure what a salvo saves on the link, run 
+ * make link SALVO_SHOTS=n LINK_RUN_FLAGS="-c 7" (the salvo scenarios of
+ * script.c) with n = 1 and then 3, deleting link_run_native in between,
+ * and compare the average wait for a reply, which is how long a turn
+ * takes. At 2400 baud a turn of single shots took 23.6 ms on average
+ * (71 ms for three shots) and a 3 shot salvo 38.4 ms. */
+#ifndef SALVO_SHOTS
+#define SALVO_SHOTS 1
+#endif
+#define SALVO_HEADER 0xf0
+#define SALVO_REPLY 0x80
+/* 'X' and the next letter are never valid shots (their column is too big) */
+#define SUNK_REPLY 'X'
+#define FRAME_SIZE (SALVO_SHOTS > 1 ? SALVO_SHOTS + 1 : 1)
+
+#if SALVO_SHOTS + NUM_SHIPS > 7
+#error "a salvo reply has no room for this many shots"
+#endif
+
+#if COLS_NUM >= RESYNC_BYTE
+#error "shots could be mistaken for resync bytes"
+#endif
+
+/* What resolveShot found. SHOT_SUNK is followed by one value per ship. */
+#define SHOT_MISS 0
+#define SHOT_HIT 1
+#define SHOT_SUNK 2
+
+/* Light the cells that could still hold one of the opponent's ships 
+ * while firing, set with make TARGET_OVERLAY=1. The overlay blinks so
+ * that it can be told apart from hits. */
+#ifndef TARGET_OVERLAY
+#define TARGET_OVERLAY 0
+#endif
+#define OVERLAY_BLINK_TICKS (LOOP_RATE / 4)
 
 /* Constants to control cursor blinking */
 #define NUMBER_OF_ITERATIONS_CURSOR_ON 5
@@ -47,58 +141,148 @@
 
 #define TEXT_SPEED 10
 
+/* Room for "ENTERED nnnnn nnnnn nnnnn nnnnn nnnnn US nnnnn nnnnn nnnnn nnnnn nnnnn ",
+ * which is longer than the memory and sleep reports */
+#define REPORT_SIZE 72
+
+/* Transition times are shown in microseconds */
+#define US_PER_TIMER_TICK (1000000UL / TIMER_RATE)
+
+/* What the button shows on the end screen, in turn */
+#define END_SCREEN_RESULT 0
+#define END_SCREEN_MEMORY 1
+#define END_SCREEN_SLEEP 2
+#define END_SCREEN_PHASES 3
+#define NUM_END_SCREENS 4
+
 #define BOAT_LENGTH 3
-#define BOAT_MATRIX {0x00, 0x08, 0x08, 0x08, 0x00}
 
 
-static uint8_t sendBuffer = 0;
-static uint8_t receiveBuffer = 0;
+/* End screen state */
+static uint8_t endScreen = END_SCREEN_RESULT;
+static bool isRematchWanted = false;
+static bool isRematchOffered = false; //The opponent has asked for a rematch
 
 static int playerNum; //Specifies if player 1 or 2
 
 
-typedef struct gameData_s
+/* Everything that belongs to one match, kept together so that a new 
+ * match can be started by clearing it and so that its size is known 
+ * (it is shown in the memory report). Boards are int matrices (see 
+ * int_matrix.h). The fields used on every tick of the game and 
+ * communication loops come first, and the boards, which only change
+ * when a ship is placed or a shot is made, come last. */
+typedef struct match_s
 {
-    //Takes values 'P' -> PlacementLoop, 'F' -> fireLoop, 'W' -> WaitingLoop, 'E' -> EndLoop
-    char phase;
-    //Takes values 'P' -> PlacementLoop, 'F' -> fireLoop, 'W' -> WaitingLoop, 'E' -> EndLoop, 'N' -> None
-    char lastPhase;
-    Cursor* cursor;
-    Cursor* shipHull;
-    bool isLastMoveHit;
-    int yourHits;
-    int opponentHits;
     bool readyToSend;
     bool readyToReceive;
+    uint8_t sendBuffer;
+    uint8_t receiveBuffer;
+    uint8_t receiveFrame[FRAME_SIZE]; //The opponent's shots, filled in by communicationLoop
+    uint8_t receiveLength;
+    uint8_t salvo[SALVO_SHOTS]; //The shots marked so far this turn
+    uint8_t numMarked;
+    uint8_t markMatrix[COLS_NUM];
+    
+    bool isLastMoveHit;
+    uint8_t turns; //The number of shots (or salvos) exchanged
+    uint8_t yourHits;
+    uint8_t opponentHits;
+    uint8_t shipsPlaced;
+    uint8_t shipCellsLeft[NUM_SHIPS]; //The cells of each of our ships that have not been hit
+    uint8_t opponentSunk; //Bit i is set once the opponent's ship i has sunk
+    uint8_t lastMoveSunk; //The opponent's ships sunk by our last shot (or salvo)
+    uint8_t resyncAnswer; //The resync byte we resumed with, answered until the next shot
+    uint8_t fleet[COLS_NUM]; //Where our ships were placed
+    uint8_t afloat[COLS_NUM]; //The parts of our ships that have not been hit
+    uint8_t hitMatrix[COLS_NUM]; //Where our shots have hit
+    uint8_t missMatrix[COLS_NUM]; //Where our shots have missed
+    uint8_t ships[NUM_SHIPS][COLS_NUM]; //Where each of our ships was placed
+#if TARGET_OVERLAY
+    Candidates candidates; //Where the opponent's ships could still be
+#endif
+} Match;
+
+
+typedef struct gameData_s
+{
+    //The phase to run, one of the PHASE_* values. Set this to move to another phase.
+    uint8_t phase;
+    PhaseMachine phaseMachine;
+    Cursor* cursor;
+    Ship* ship;
+    MusicObj* music;
+    Match match;
 } GameData;
 
 
-/* Background music */
-char* theme = "<C,C,G,C,G#,C,C,F,C,G,C,G#,C,C,F,G,C,C,G,C,G#,C,C,A#,C,G#,C,G,C,C,G,G#,E#,E#,G#,E#,E#,G#,E#,G#,E#,E#,G,E#,E#,G,E#,G,D#,D#,G,D#,A#,D#,G#,G,D,D,G,D,G#,D,G,F,>1000";													   
-														   
-extern uint8_t shipMatrix[ROWS_NUM][COLS_NUM];						   
-static uint8_t shipIntMatrix[COLS_NUM] = {0x00};
+/* The match as last saved to, or loaded from, EEPROM */
+static Snapshot snapshot;
+
+/* True if the waiting phase was entered straight from the placement phase */
+static bool isFirstWait = false;
+
+/* Game loop ticks since the player last touched anything while waiting */
+static uint16_t waitingIdleTicks = 0;
+
+
+
+static bool resyncAnswered(Match* match, uint8_t byte)
+/* Answers byte if it is the other board still trying to resume the 
+ * match we resumed, because it missed our answer. Returns true if it 
+ * was answered. */
+{
+	if (match->resyncAnswer == 0 || byte != match->resyncAnswer) {
+		return false;
+	}
+	LINK_PUTC(byte);
+	TRACE_EVENT(TRACE_IR_SEND, byte);
+	return true;
+}
 
 
 
 void communicationLoop (void* data)
-/* Sends what is in the sendBuffer and reads into the receiveBuffer, but
- * only if readyToSend or readyToReceive are set to true respectively.*/
+/* Sends what is in the sendBuffer and reads a frame of the opponent's 
+ * shots into receiveFrame, but only if readyToSend or readyToReceive 
+ * are set to true respectively.*/
 {
+	PROFILE_BEGIN(PROFILE_COMMUNICATION);
+	TRACE_EVENT(TRACE_BEGIN, PROFILE_COMMUNICATION);
 	GameData* gameData = data;
+	Match* match = &gameData->match;
+	uint8_t byte = 0;
 	
-	if (gameData->readyToReceive) {
-		if (ir_uart_read_ready_p()) {
-			receiveBuffer = ir_uart_getc();
-			gameData->readyToReceive = false;
+	while (match->readyToReceive && LINK_READY()) {
+		byte = LINK_GETC();
+		TRACE_EVENT(TRACE_IR_RECEIVE, byte);
+		if (match->receiveLength == 0 && resyncAnswered(match, byte)) {
+			continue;
+		}
+		/* Skip anything before the start of a frame (e.g a repeated shot) */
+		if (SALVO_SHOTS > 1 && match->receiveLength == 0 && byte != SALVO_HEADER + SALVO_SHOTS) {
+			continue;
+		}
+		/* readyToReceive is cleared once the frame is full, so this never
+		 * happens, but gcc can't tell (-Warray-bounds in the native build) */
+		if (match->receiveLength >= FRAME_SIZE) {
+			break;
+		}
+		match->receiveFrame[match->receiveLength] = byte;
+		match->receiveLength++;
+		if (match->receiveLength == FRAME_SIZE) {
+			match->readyToReceive = false;
 		}
 	}
 	
-	if (gameData->readyToSend) {
-		ir_uart_putc(sendBuffer);
-		gameData->readyToSend = false;
-		sendBuffer = 0;
-	}	
+	if (match->readyToSend) {
+		LINK_PUTC(match->sendBuffer);
+		TRACE_EVENT(TRACE_IR_SEND, match->sendBuffer);
+		match->readyToSend = false;
+		match->sendBuffer = 0;
+	}
+	TRACE_EVENT(TRACE_END, PROFILE_COMMUNICATION);
+	PROFILE_END();
 }
 
 
@@ -114,197 +298,605 @@ void tinygl_general_init(void)
 
 
 
-void endLoop (GameData* gameData)
-/* Display the end game screen. Win or loose messages are displayed 
+static char* appendText(char* text, const char* string)
+/* Copies string to text, without its terminating null. Returns a 
+ * pointer to the character after the copy. */
+{
+    while (*string != '\0') {
+        *text = *string;
+        text++;
+        string++;
+    }
+    return text;
+}
+
+
+
+static char* appendNumber(char* text, uint16_t number)
+/* Writes number in decimal followed by a space at text. Returns a 
+ * pointer to the character after the space. */
+{
+    char digits[5];
+    int numDigits = 0;
+
+    do {
+        digits[numDigits] = '0' + number % 10;
+        number /= 10;
+        numDigits++;
+    } while (number > 0);
+
+    while (numDigits > 0) {
+        numDigits--;
+        *text = digits[numDigits];
+        text++;
+    }
+    *text = ' ';
+    return text + 1;
+}
+
+
+
+static char report[REPORT_SIZE];
+
+
+
+static void memoryReportShow(void)
+/* Scrolls a report of SRAM use across the screen: bytes used by static 
+ * variables, the stack peak over the whole game, the size of the match
+ * state, and the stack peak during each phase (placement, fire, 
+ * waiting, end, resync). */
+{
+    char* text = report;
+    uint8_t phase = 0;
+
+    text = appendText(text, "RAM ");
+    text = appendNumber(text, memUsageStatic());
+    text = appendText(text, "STACK ");
+    text = appendNumber(text, memUsageStackPeak());
+    text = appendText(text, "MATCH ");
+    text = appendNumber(text, sizeof(Match));
+    text = appendText(text, "PHASES ");
+    for (phase = 0; phase < MEM_USAGE_MAX_PHASES; phase++) {
+        text = appendNumber(text, memUsagePhasePeak(phase));
+    }
+    *text = '\0';
+    tinygl_text(report);
+}
+
+
+
+static void sleepReportShow(void)
+/* Scrolls the percentage of time the CPU was asleep during each phase 
+ * across the screen. */
+{
+    char* text = report;
+    uint8_t phase = 0;
+
+    text = appendText(text, "SLEEP% ");
+    for (phase = 0; phase < IDLE_MAX_PHASES; phase++) {
+        text = appendNumber(text, idleSleepPercent(phase));
+    }
+    *text = '\0';
+    tinygl_text(report);
+}
+
+
+
+static void phaseReportShow(const PhaseMachine* machine)
+/* Scrolls how many times each phase was entered, and the longest its
+ * exit and entry actions took in microseconds, across the screen. */
+{
+    char* text = report;
+    uint8_t phase = 0;
+    uint32_t us = 0;
+
+    text = appendText(text, "ENTERED ");
+    for (phase = 0; phase < PHASE_MAX_PHASES; phase++) {
+        text = appendNumber(text, machine->entries[phase]);
+    }
+    text = appendText(text, "US ");
+    for (phase = 0; phase < PHASE_MAX_PHASES; phase++) {
+        us = machine->maxTransitionTicks[phase] * US_PER_TIMER_TICK;
+        text = appendNumber(text, us > UINT16_MAX ? UINT16_MAX : us);
+    }
+    *text = '\0';
+    tinygl_text(report);
+}
+
+
+
+static void endTextShow(GameData* gameData)
+/* Scrolls the win or loose message across the screen. */
+{
+    if (gameData->match.yourHits >= MAX_NUM_HITS) {
+        tinygl_text ("YOU WIN! ");
+    } else {
+        tinygl_text ("YOU LOOSE ");
+    }
+}
+
+
+
+void endEntry (void* data)
+/* Sets up the end game screen. Win or loose messages are displayed 
  * depending of if the player won and lost the game.*/
 {
-    if (gameData->lastPhase != 'E') { //i.e if we were previously in a different Loop/Phase
-        tinygl_general_init();
-        gameData->lastPhase = 'E';
+    GameData* gameData = data;
+
+    tinygl_general_init();
+    inputClear();
+    endScreen = END_SCREEN_RESULT;
+    isRematchWanted = false;
+    isRematchOffered = false;
+    endTextShow(gameData);
+    if (gameData->match.yourHits >= MAX_NUM_HITS) {
+        musicPlay(gameData->music, winTune);
+    } else {
+        musicPlay(gameData->music, loseTune);
+    }
+}
 
-        if (gameData->yourHits >= MAX_NUM_HITS) {
-            tinygl_text ("YOU WIN! ");
+
+
+static void matchReset(GameData* gameData)
+/* Puts everything about the match back to how it is at start up, so 
+ * that a new match can be played without resetting the board. Drivers
+ * and music are left running. */
+{
+	Cursor* cursor = gameData->cursor;
+	Ship* ship = gameData->ship;
+	
+	memset(&gameData->match, 0, sizeof(gameData->match));
+	cursor->column = DEFAULT_COL;
+	cursor->row = DEFAULT_ROW;
+	cursor->rowNum = (1 << DEFAULT_ROW);
+	ship->length = BOAT_LENGTH;
+	ship->direction = HORIZONTAL;
+	ship->centre = *cursor;
+}
+
+
+
+void endLoop (void* data)
+/* Display the end game screen. Pressing the button switches between 
+ * the win/loose message, a report of how much SRAM was used, a report 
+ * of how long the CPU slept and a report of the phase transitions. 
+ * Pushing the navswitch asks for a rematch, which starts once both 
+ * players have asked. The loser of this match goes first. */
+{
+    GameData* gameData = data;
+    Match* match = &gameData->match;
+    static uint8_t ticks = 0;
+    uint8_t event = inputEventGet();
+    uint8_t byte = 0;
+
+    if (event == INPUT_BUTTON) {
+        endScreen = (endScreen + 1) % NUM_END_SCREENS;
+        if (endScreen == END_SCREEN_MEMORY) {
+            memoryReportShow();
+        } else if (endScreen == END_SCREEN_SLEEP) {
+            sleepReportShow();
+        } else if (endScreen == END_SCREEN_PHASES) {
+            phaseReportShow(&gameData->phaseMachine);
         } else {
-            tinygl_text ("YOU LOOSE ");
+            endTextShow(gameData);
+        }
+    } else if (event == INPUT_PUSH && !isRematchWanted) {
+        isRematchWanted = true;
+        ticks = LOOP_RATE / REMATCH_RATE; /* Ask straight away */
+        tinygl_text("REMATCH ");
+    }
+    
+    while (LINK_READY()) {
+        byte = LINK_GETC();
+        if ((byte == REMATCH_BYTE || byte == REMATCH_ANSWER) && !isRematchOffered) {
+            isRematchOffered = true;
+            if (!isRematchWanted) {
+                tinygl_text("REMATCH? ");
+            }
+        }
+    }
+    
+    if (isRematchWanted) {
+        ticks++;
+        if (isRematchOffered) {
+            playerNum = match->yourHits >= MAX_NUM_HITS ? 2 : 1;
+            matchReset(gameData);
+            gameData->phase = PHASE_PLACEMENT;
         }
+        /* After a reset this answers the other board, and placementLoop
+         * answers it again if that is lost and it asks again */
+        if (ticks >= LOOP_RATE / REMATCH_RATE || isRematchOffered) {
+            ticks = 0;
+            match->sendBuffer = isRematchOffered ? REMATCH_ANSWER : REMATCH_BYTE;
+            match->readyToSend = true;
+        }
+    }
+    PROFILE_CALL(PROFILE_TINYGL, tinygl_update());
+}
+
+
+
+bool isShotValid(uint8_t position)
+/* Returns true if a position byte from the opponent is on the board. 
+ * Rows and columns are sent starting from 1 (see recordShot). */
+{
+	uint8_t row = position >> COL_BITS;
+	uint8_t column = position & COL_MASK;
+	
+	return row >= 1 && row <= ROWS_NUM && column >= 1 && column <= COLS_NUM;
+}
+
+
+
+uint8_t resolveShot(GameData* gameData, uint8_t position)
+/* Checks a valid position byte from the opponent against our ships. 
+ * Returns SHOT_MISS, SHOT_HIT, or SHOT_SUNK + s if the shot hit the 
+ * last cell of ship s that was afloat. Hits are counted. */
+{
+	Match* match = &gameData->match;
+	uint8_t rowNum = 1 << ((position >> COL_BITS) - 1);
+	uint8_t column = (position & COL_MASK) - 1;
+	uint8_t ship = 0;
+	
+	if (!(match->afloat[column] & rowNum)) {
+		return SHOT_MISS;
+	}
+	match->afloat[column] &= ~rowNum; /* You can't hit the same place twice */
+	match->opponentHits++;
+	
+	/* Only the ship that was hit can have sunk */
+	while (ship < NUM_SHIPS - 1 && !(match->ships[ship][column] & rowNum)) {
+		ship++;
+	}
+	match->shipCellsLeft[ship]--;
+	return match->shipCellsLeft[ship] == 0 ? SHOT_SUNK + ship : SHOT_HIT;
+}
+
+
+
+void waitingEntry(void* data)
+/* Sets up the waiting screen and starts listening for the opponent's shot. */
+{
+    GameData* gameData = data;
+    Match* match = &gameData->match;
+
+    tinygl_general_init();
+    ledmat_init();
+    inputClear();
+    match->readyToReceive = true;
+    match->receiveLength = 0;
+    waitingIdleTicks = 0;
+    
+    /*If we were previously in the placement phase, then it is the first time we have waited */
+    isFirstWait = gameData->phaseMachine.previous == PHASE_PLACEMENT ? true : false;
+
+    if (match->lastMoveSunk & (1 << CANDIDATES_LONG_SHIP)) {
+        tinygl_text ("BIG SHIP SUNK! ");
+    } else if (match->lastMoveSunk & (1 << CANDIDATES_SHORT_SHIP)) {
+        tinygl_text ("SMALL SHIP SUNK! ");
+    } else if (match->isLastMoveHit) {
+        tinygl_text ("HIT! ");
+    } else {
+        tinygl_text ("MISS ");
     }
-    tinygl_update();
 }
 
 
 
-void waitingLoop(GameData* gameData)
+void waitingLoop(void* data)
 /* A loop that handles the waiting screen that players see while they 
  * are waiting for the opponent to end their turn. This loop also 
  * listens for a fire/shoot message from the opponent and gives them hit
  * or miss feedback accordingly. Once hit/miss feedback is given to the 
  * opponent, the player is moved to the fire phase or end phase. */
 {
-	int column = 0;
-	int row = 0;
+	GameData* gameData = data;
+	Match* match = &gameData->match;
 	static uint8_t displayCol = 0;
-	static bool isFirstCall = false;
+	uint8_t hits = 0;
+	uint8_t sunk = 0;
+	uint8_t shot = 0;
+	uint8_t result = SHOT_MISS;
 	
-    if (gameData->lastPhase != 'W') { //i.e if we were previously in a different Loop/Phase
-        tinygl_general_init();
-        ledmat_init();
-        gameData->readyToReceive = true;
-        
-        /*If we were previously in the placement phase, then it is the first time we have called this function */
-        isFirstCall = gameData->lastPhase == 'P' ? true : false;
-
-        if (gameData->isLastMoveHit) {
-            tinygl_text ("HIT! ");
-        } else {
-            tinygl_text ("MISS ");
-        }
-        gameData->lastPhase = 'W';
-    }
-    
-    
-    if (receiveBuffer != 0) {
-		row = receiveBuffer >> COL_BITS;  
-		column = receiveBuffer - (row << COL_BITS); 
-		
-		/* Check that column and row are in the acceptable ranges */
-		if (column <= COLS_NUM && row <= ROWS_NUM) {
-			if (shipMatrix[row-1][column-1] == 1) {
-				shipMatrix[row-1][column-1] = 0; /* You can't hit the same place twice */
-				gameData->opponentHits++;
-				sendBuffer = 'H';
-			} else {
-				sendBuffer = 'M';
+    if (match->receiveLength == FRAME_SIZE) {
+		if (SALVO_SHOTS == 1) {
+			/* Check that column and row are in the acceptable ranges */
+			if (isShotValid(match->receiveFrame[0])) {
+				result = resolveShot(gameData, match->receiveFrame[0]);
+				match->sendBuffer = result == SHOT_MISS ? 'M' : result == SHOT_HIT ? 'H' : SUNK_REPLY + result - SHOT_SUNK;
 			}
-			
-			gameData->readyToSend = true;
-			receiveBuffer = 0;
-			gameData->phase = gameData->opponentHits >= MAX_NUM_HITS ? 'E' : 'F';
-			
 		} else {
-			receiveBuffer = 0;
-			gameData->readyToReceive = true;
+			/* Resolve the whole salvo at once, invalid shots count as misses */
+			for (shot = 0; shot < SALVO_SHOTS; shot++) {
+				if (isShotValid(match->receiveFrame[shot + 1])) {
+					result = resolveShot(gameData, match->receiveFrame[shot + 1]);
+					if (result != SHOT_MISS) {
+						hits |= 1 << shot;
+					}
+					if (result >= SHOT_SUNK) {
+						sunk |= 1 << (result - SHOT_SUNK);
+					}
+				}
+			}
+			match->sendBuffer = SALVO_REPLY | (sunk << SALVO_SHOTS) | hits;
 		}
+		match->receiveLength = 0;
+		
+		if (match->sendBuffer != 0) {
+			TRACE_EVENT(TRACE_SHOT, match->sendBuffer);
+			match->readyToSend = true;
+			match->turns++;
+			match->resyncAnswer = 0;
+			gameData->phase = match->opponentHits >= MAX_NUM_HITS ? PHASE_END : PHASE_FIRE;
+		} else {
+			match->readyToReceive = true;
+		}
+	}
+	
+    /* Turn the display off if nobody has touched anything for a while */
+    if (inputEventGet() != INPUT_NONE || inputButtonDown()) {
+		waitingIdleTicks = 0;
+	} else if (IDLE_DISPLAY_TIMEOUT > 0 && waitingIdleTicks < LOOP_RATE * IDLE_DISPLAY_TIMEOUT) {
+		waitingIdleTicks++;
+	}
+	if (IDLE_DISPLAY_TIMEOUT > 0 && waitingIdleTicks >= LOOP_RATE * IDLE_DISPLAY_TIMEOUT) {
+		ledmat_display_column(0, displayCol);
+		return;
 	}
 	
-    button_update();
     /* If the button is down show the player their ship positions */
-    if (button_down_p(BUTTON1) || isFirstCall) {
-		ledmat_display_column(shipIntMatrix[displayCol], displayCol);
+    if (inputButtonDown() || isFirstWait) {
+		ledmat_display_column(match->fleet[displayCol], displayCol);
 		displayCol++;
 		displayCol %= COLS_NUM;
     } else {
-		tinygl_update();
+		PROFILE_CALL(PROFILE_TINYGL, tinygl_update());
 	}
 }
 
 
 
-bool isHit(void)
-/* Returns true if the receiveBuffer contains the hit character 'H'. 
- * Otherwise, returns false. */
+static bool isReply(uint8_t byte)
+/* Returns true if byte is a well formed reply to a turn's shots. */
 {
-	if (receiveBuffer == 'H') {
-		return true;
-	} else {
-		return false;
+	if (SALVO_SHOTS == 1) {
+		return byte == 'H' || byte == 'M' || (byte >= SUNK_REPLY && byte < SUNK_REPLY + NUM_SHIPS);
 	}
+	return (byte & ~((1 << (SALVO_SHOTS + NUM_SHIPS)) - 1)) == SALVO_REPLY;
 }
 
 
 
-bool recordShot(GameData* gameData, uint8_t hitMatrix[], uint8_t missMatrix[])
-/* Checks to see if a shot has been made. Returns true if a shot is 
- * made, false otherwise. If a shot has been made, this function 
- * queries the other UCFK to see if it was a hit. If it was a hit, then
- * it is recorded in the hitMatrix and otherwise it is recorded in the 
- * missMatrix. */
+static uint8_t sunkShips(const Match* match)
+/* Returns the opponent's ships that the reply in the receiveBuffer says
+ * were sunk this turn, with bit s set for ship s. */
 {
+	if (SALVO_SHOTS == 1) {
+		if (match->receiveBuffer >= SUNK_REPLY && match->receiveBuffer < SUNK_REPLY + NUM_SHIPS) {
+			return 1 << (match->receiveBuffer - SUNK_REPLY);
+		}
+		return 0;
+	}
+	return (match->receiveBuffer >> SALVO_SHOTS) & ((1 << NUM_SHIPS) - 1);
+}
+
+
+
+bool isHit(const Match* match, uint8_t shot)
+/* Returns true if the reply in the receiveBuffer says that the shot-th
+ * shot of the turn hit. Otherwise, returns false. */
+{
+	if (SALVO_SHOTS == 1) {
+		return match->receiveBuffer == 'H' || sunkShips(match) != 0;
+	}
+	return (match->receiveBuffer & (1 << shot)) != 0;
+}
+
+
+
+static void salvoSend(const Match* match)
+/* Sends the shots marked this turn to the opponent. */
+{
+	uint8_t shot = 0;
+	
+	if (SALVO_SHOTS > 1) {
+		LINK_PUTC(SALVO_HEADER + SALVO_SHOTS);
+		TRACE_EVENT(TRACE_IR_SEND, SALVO_HEADER + SALVO_SHOTS);
+	}
+	for (shot = 0; shot < SALVO_SHOTS; shot++) {
+		LINK_PUTC(match->salvo[shot]);
+		TRACE_EVENT(TRACE_IR_SEND, match->salvo[shot]);
+	}
+}
+
+
+
+bool recordShot(GameData* gameData, uint8_t event)
+/* Checks to see if the input event is a shot being made. Each shot is 
+ * marked in markMatrix until SALVO_SHOTS shots have been marked. Then 
+ * this function queries the other UCFK to see which of them hit and 
+ * returns true, otherwise it returns false. Hits are recorded in the 
+ * hitMatrix and misses in the missMatrix. */
+{
+	Match* match = &gameData->match;
 	Cursor* cursor = gameData->cursor;
 	/* Since 0 in the receiveBuffer is considered "no message has arrived", we 
 	 * need to add one to row and col so that the position (0,0) can be selected. */
     uint8_t cursorPosition = ((cursor->row + 1) << COL_BITS) + (cursor->column + 1);
+#if TARGET_OVERLAY
+    uint8_t turnHits[COLS_NUM] = {0};
+#endif
+    uint8_t shot = 0;
+    uint8_t row = 0;
+    uint8_t column = 0;
+    timer_tick_t lastInput = 0;
+    bool isAnswered = false;
      
-    if (navswitch_down_p (NAVSWITCH_PUSH)) {
-		sendBuffer = cursorPosition;
-		ir_uart_putc(sendBuffer);
-		 
-		while (!ir_uart_read_ready_p()) {
-			button_update();
-			if (button_push_event_p(BUTTON1)) {
-				ir_uart_putc(sendBuffer);
+    if (event != INPUT_PUSH || (match->markMatrix[cursor->column] & cursor->rowNum)) {
+		return false;
+	}
+	match->markMatrix[cursor->column] |= cursor->rowNum;
+	match->salvo[match->numMarked] = cursorPosition;
+	match->numMarked++;
+	if (match->numMarked < SALVO_SHOTS) {
+		return false;
+	}
+	
+	/* Throw away anything left over (e.g a repeated reply) so that it is
+	 * not taken as the reply to these shots, but answer the other board 
+	 * if it is still resuming so that it reads them */
+	while (LINK_READY()) {
+		resyncAnswered(match, LINK_GETC());
+	}
+	salvoSend(match);
+	lastInput = timer_get();
+	do {
+		while (!LINK_READY()) {
+			TRACE_WAIT_MARK();
+			/* The scheduler is blocked while we wait, so sample the input
+			 * here, but only as often as the input task so that the
+			 * navswitch and button are debounced the same way */
+			if ((timer_tick_t) (timer_get() - lastInput) < TIMER_RATE / INPUT_TASK_RATE) {
+				continue;
 			}
-		}
-		 
-		receiveBuffer = ir_uart_getc();
-		if (receiveBuffer != 0) {
-			if (isHit()) {
-				hitMatrix[cursor->column] |= cursor->rowNum;
-				gameData->isLastMoveHit = true;
-				gameData->yourHits++;
-				 
-			} else {
-				missMatrix[cursor->column] |= cursor->rowNum;
-				gameData->isLastMoveHit = false;
+			lastInput += TIMER_RATE / INPUT_TASK_RATE;
+			inputSample();
+			if (inputEventGet() == INPUT_BUTTON) {
+				salvoSend(match);
 			}
-			receiveBuffer = 0;
-			return true; 
 		}
+		match->receiveBuffer = LINK_GETC();
+		TRACE_EVENT(TRACE_IR_RECEIVE, match->receiveBuffer);
+		/* If the other board was still resuming it threw the shots away,
+		 * so they are sent again once it has been answered */
+		isAnswered = resyncAnswered(match, match->receiveBuffer);
+		if (isAnswered) {
+			salvoSend(match);
+		}
+	} while (isAnswered);
+
+	if (!isReply(match->receiveBuffer)) {
+		/* Not a reply (e.g a stray resync or rematch byte), the shots 
+		 * stay marked and can be sent again */
+		match->numMarked--;
+		match->markMatrix[cursor->column] &= ~cursor->rowNum;
+		match->receiveBuffer = 0;
 		return false;
-    } else {
-        return false;
-    }
+	}
+	
+	match->isLastMoveHit = false;
+	match->turns++;
+	match->resyncAnswer = 0;
+	for (shot = 0; shot < SALVO_SHOTS; shot++) {
+		row = (match->salvo[shot] >> COL_BITS) - 1;
+		column = (match->salvo[shot] & COL_MASK) - 1;
+		if (isHit(match, shot)) {
+			match->hitMatrix[column] |= 1 << row;
+#if TARGET_OVERLAY
+			turnHits[column] |= 1 << row;
+#endif
+			match->isLastMoveHit = true;
+			match->yourHits++;
+		} else {
+			/* A cell that has already been hit is a miss the second time,
+			 * but a ship is still there */
+#if TARGET_OVERLAY
+			if (!(match->hitMatrix[column] & (1 << row))) {
+				candidatesMiss(&match->candidates, column, row);
+			}
+#endif
+			match->missMatrix[column] |= 1 << row;
+		}
+	}
+	match->lastMoveSunk = sunkShips(match) & ~match->opponentSunk;
+	match->opponentSunk |= match->lastMoveSunk;
+#if TARGET_OVERLAY
+	candidatesTurn(&match->candidates, match->hitMatrix, turnHits, match->opponentSunk, match->lastMoveSunk);
+#endif
+	if (match->lastMoveSunk) {
+		musicPlay(gameData->music, sunkTune);
+	} else {
+		musicPlay(gameData->music, match->isLastMoveHit ? hitTune : missTune);
+	}
+	clearIntMatrix(match->markMatrix, COLS_NUM);
+	match->numMarked = 0;
+	match->receiveBuffer = 0;
+	return true;
 }
 
 
 
-void fireLoop (GameData* gameData)
+void fireEntry (void* data)
+/* Sets up the drivers used by the firing phase. */
+{
+    (void) data;
+    ledmat_init();
+    inputClear();
+}
+
+
+
+void fireLoop (void* data)
 /* A loop that handles the firing phase of the game. When players push 
  * the navswitch down, their shot will be recorded as hit or miss and 
  * they will move on to the waiting phase or end phase. */
 {
+    GameData* gameData = data;
+    Match* match = &gameData->match;
     Cursor* cursor = gameData->cursor;
     static bool isTurnOver = false;
     static int frameCounter = 0;
     static int i = 0;
-    static uint8_t hitMatrix[COLS_NUM] = {0x00};
-    static uint8_t missMatrix[COLS_NUM] = {0};
-    uint8_t* currentMatrix = hitMatrix; /* A pointer to the current matrix being displayed */
-
-    if (gameData->lastPhase != 'F') { //i.e if we were previously in a different Loop/Phase
-        ledmat_init();
-        button_init();
-        gameData->lastPhase = 'F';
-    }
+#if TARGET_OVERLAY
+    static uint8_t overlayTicks = 0;
+#endif
+    uint8_t* currentMatrix = match->hitMatrix; /* A pointer to the current matrix being displayed */
+    uint8_t overlay = 0;
+    uint8_t event = INPUT_NONE;
 
-    navswitch_update();
-    button_update();
-    updateCursorPosition(cursor);
-
-    if (button_down_p(BUTTON1)) {
-            currentMatrix = missMatrix;
+    if (inputButtonDown()) {
+            currentMatrix = match->missMatrix;
         } else {
-            currentMatrix = hitMatrix;
+            currentMatrix = match->hitMatrix;
+    }
+    
+    /* Work out a little more of the overlay each tick, and show it for 
+     * half of each blink with the hits */
+#if TARGET_OVERLAY
+    candidatesStep(&match->candidates, match->hitMatrix, match->missMatrix);
+    overlayTicks = (overlayTicks + 1) % (2 * OVERLAY_BLINK_TICKS);
+    if (overlayTicks < OVERLAY_BLINK_TICKS && !inputButtonDown()) {
+        overlay = match->candidates.overlay[i];
     }
+#endif
 
     //Display the currently selected Matrix
     if (i == cursor->column) {
 		//Only display the cursor for certain frame intervals to simulate blinking
         if (frameCounter > START_CURSOR_DISPLAY_NUM) {
-            ledmat_display_column(currentMatrix[i] | cursor->rowNum, i);
+            ledmat_display_column(currentMatrix[i] | overlay | match->markMatrix[i] | cursor->rowNum, i);
             frameCounter = frameCounter >= END_CURSOR_DISPLAY_NUM ? 0 : frameCounter + 1;
         } else {
-            ledmat_display_column(currentMatrix[i], i);
+            ledmat_display_column(currentMatrix[i] | overlay | match->markMatrix[i], i);
             frameCounter++;
         }
         
     } else {
-            ledmat_display_column(currentMatrix[i], i);
+            ledmat_display_column(currentMatrix[i] | overlay | match->markMatrix[i], i);
     }
     
-    isTurnOver = recordShot(gameData, hitMatrix, missMatrix);
-    if (isTurnOver) {
-        gameData->phase = gameData->yourHits >= MAX_NUM_HITS ? 'E' : 'W';
-        isTurnOver = false;
+    /* Only do work for the navswitch/button when something has happened */
+    event = inputEventGet();
+    while (event != INPUT_NONE) {
+        updateCursorPosition(cursor, event);
+        isTurnOver = recordShot(gameData, event);
+        if (isTurnOver) {
+            gameData->phase = match->yourHits >= MAX_NUM_HITS ? PHASE_END : PHASE_WAITING;
+            isTurnOver = false;
+            break;
+        }
+        event = inputEventGet();
     }
     i++;
     i = i % COLS_NUM;
@@ -318,7 +910,10 @@ int selectPlayer(void)
 {
 	int playerNumber = 1;
 	bool isSelected = false;
+	int inputTicks = 0;
+	uint8_t event = INPUT_NONE;
 	system_init();
+	inputInit();
 	tinygl_init(PACER_RATE);
     tinygl_font_set (&font5x7_1);
     tinygl_text("1");
@@ -328,17 +923,22 @@ int selectPlayer(void)
     while (!isSelected) {
 		pacer_wait();
 		tinygl_update();
-		navswitch_update();
 		
-		if (navswitch_push_event_p(NAVSWITCH_NORTH)) {
+		/* The scheduler is not running yet, so sample the input from here */
+		inputTicks++;
+		if (inputTicks >= PACER_RATE / INPUT_TASK_RATE) {
+			inputTicks = 0;
+			inputSample();
+		}
+		
+		event = inputEventGet();
+		if (event == INPUT_NORTH) {
 			tinygl_text("2");
 			playerNumber = 2;
-		} else if (navswitch_push_event_p(NAVSWITCH_SOUTH)) {
+		} else if (event == INPUT_SOUTH) {
 			tinygl_text("1");
 			playerNumber = 1;
-		}
-		
-		if (navswitch_release_event_p(NAVSWITCH_PUSH)) {
+		} else if (event == INPUT_PUSH_RELEASE) {
 			isSelected = true;
 		}	
 	}
@@ -347,76 +947,300 @@ int selectPlayer(void)
 
 
 
-void placementLoop(GameData* gameData)
-/* Allows each player to place their ships. */
+void placementEntry(void* data)
+/* Sets up the drivers used by the placement phase. */
+{
+	(void) data;
+	ledmat_init();
+	LINK_INIT();
+	inputClear();
+}
+
+
+
+void placementExit(void* data)
+/* Records where the ships were placed, so that shots can be checked 
+ * against them, and starts keeping track of where the opponent's 
+ * could be for the target overlay. */
 {
-	Cursor* shipHull = gameData->shipHull;
-	static int shipsPlaced = 0;
+	GameData* gameData = data;
+	Match* match = &gameData->match;
+	
+	memcpy(match->afloat, match->fleet, COLS_NUM);
+#if TARGET_OVERLAY
+	candidatesRebuild(&match->candidates, match->hitMatrix, match->missMatrix, 0);
+#endif
+}
+
+
+
+void placementLoop(void* data)
+/* Allows each player to place their ships. A board still on the end 
+ * screen asking for a rematch has missed the answer, so it is answered
+ * again. */
+{
+	GameData* gameData = data;
+	Match* match = &gameData->match;
+	Ship* ship = gameData->ship;
 	static int currentColumn = 0;
 	int column = 0;
-	static int boatLength = BOAT_LENGTH;
-	static uint8_t cursorMatrix[COLS_NUM] = BOAT_MATRIX;
+	uint8_t cursorMatrix[COLS_NUM] = {0};
+	uint8_t shipBits = 0;
+	uint8_t event = INPUT_NONE;
 	
-	if (gameData->lastPhase != 'P') { // i.e if we were previously in a different phase
-		ledmat_init();
-		ir_uart_init();
-		gameData->lastPhase = 'P';
+	while (LINK_READY()) {
+		if (LINK_GETC() == REMATCH_BYTE) {
+			match->sendBuffer = REMATCH_ANSWER;
+			match->readyToSend = true;
+		}
 	}
 	
-	navswitch_update();
-	button_update();
-	ledmat_display_column(shipIntMatrix[currentColumn] | cursorMatrix[currentColumn], currentColumn);
-	updateShipPosition(cursorMatrix, shipHull);
-	updateShipRotation(cursorMatrix, boatLength, shipHull);
+	PROFILE_CALL(PROFILE_SHIP_COLUMN, shipBits = shipColumn(ship, currentColumn));
+	ledmat_display_column(match->fleet[currentColumn] | shipBits, currentColumn);
 	currentColumn++;
 	currentColumn %= COLS_NUM;
 	
-	if (navswitch_release_event_p(NAVSWITCH_PUSH)) {
-		if (!isMatrixOverlap(cursorMatrix, shipIntMatrix, COLS_NUM)) { /* Since you can't place a ship on top of another ship*/
+	/* Only do work for the navswitch/button when something has happened */
+	event = inputEventGet();
+	while (event != INPUT_NONE && gameData->phase == PHASE_PLACEMENT) {
+		updateShipPosition(ship, event);
+		updateShipRotation(ship, event);
+		if (event == INPUT_PUSH_RELEASE) {
+			shipToIntMatrix(ship, cursorMatrix);
+		}
+		if (event == INPUT_PUSH_RELEASE && !isMatrixOverlap(cursorMatrix, match->fleet, COLS_NUM)) { /* Since you can't place a ship on top of another ship*/
 			/* Copy cursorMatrix into shipIntatrix */
 			for (column = 0; column < COLS_NUM; column++) {
 				if (cursorMatrix[column] != 0) {
-					shipIntMatrix[column] |= cursorMatrix[column];
+					match->fleet[column] |= cursorMatrix[column];
 				}
 			}
-			shipsPlaced++;
+			memcpy(match->ships[match->shipsPlaced], cursorMatrix, COLS_NUM);
+			match->shipCellsLeft[match->shipsPlaced] = ship->length;
+			match->shipsPlaced++;
 			
-			if (shipsPlaced == 1) {
-				boatLength = 1;
-				clearIntMatrix(cursorMatrix, COLS_NUM); 
-				cursorMatrix[DEFAULT_COL] = (1 << DEFAULT_ROW);
-				shipHull->column = DEFAULT_COL;
-				shipHull->row = DEFAULT_ROW;
+			if (match->shipsPlaced == 1) {
+				ship->length = 1;
+				ship->direction = HORIZONTAL;
+				ship->centre.column = DEFAULT_COL;
+				ship->centre.row = DEFAULT_ROW;
+				ship->centre.rowNum = (1 << DEFAULT_ROW);
 			}
-			if (shipsPlaced == 2) {
-				recordMatrix(shipIntMatrix, ROWS_NUM, COLS_NUM);
+			if (match->shipsPlaced == 2) {
 				if (playerNum == 1) {
-					gameData->phase = 'F';
+					gameData->phase = PHASE_FIRE;
 				} else {
-					gameData->phase = 'W';
+					gameData->phase = PHASE_WAITING;
 				}
 			}
-		}	
-	}	
+		}
+		event = inputEventGet();
+	}
 }
 
 
 
+static uint8_t countBits(const uint8_t intMatrix[])
+/* Returns the number of cells set in an int matrix of COLS_NUM columns. */
+{
+	uint8_t count = 0;
+	uint8_t column = 0;
+	uint8_t bits = 0;
+	
+	for (column = 0; column < COLS_NUM; column++) {
+		for (bits = intMatrix[column]; bits != 0; bits &= bits - 1) {
+			count++;
+		}
+	}
+	return count;
+}
+
+
+
+static void matchSave(GameData* gameData)
+/* Saves the match to EEPROM so that it can be resumed after a reset. */
+{
+	Match* match = &gameData->match;
+	uint8_t column = 0;
+	uint8_t row = 0;
+	
+	/* The short ship is one cell, so only its row and column are saved */
+	for (column = 0; column < COLS_NUM; column++) {
+		for (row = 0; row < ROWS_NUM; row++) {
+			if (match->ships[CANDIDATES_SHORT_SHIP][column] & (1 << row)) {
+				snapshot.shipColumn = column;
+				snapshot.shipRow = row;
+			}
+		}
+	}
+	snapshot.opponentSunk = match->opponentSunk;
+	snapshot.phase = gameData->phase;
+	snapshot.playerNum = playerNum;
+	snapshot.isLastMoveHit = match->isLastMoveHit;
+	snapshot.turns = match->turns;
+	memcpy(snapshot.fleet, match->fleet, COLS_NUM);
+	memcpy(snapshot.afloat, match->afloat, COLS_NUM);
+	memcpy(snapshot.hitMatrix, match->hitMatrix, COLS_NUM);
+	memcpy(snapshot.missMatrix, match->missMatrix, COLS_NUM);
+	snapshotSave(&snapshot);
+}
+
+
+
+static void matchRestore(GameData* gameData)
+/* Puts the match back the way it was when snapshot was saved. The hit
+ * counts, our ships and where the opponent's could be are worked out 
+ * from the boards. */
+{
+	Match* match = &gameData->match;
+	uint8_t shipAfloat[COLS_NUM];
+	uint8_t ship = 0;
+	uint8_t column = 0;
+	
+	memset(match->ships, 0, sizeof(match->ships));
+	match->ships[CANDIDATES_SHORT_SHIP][snapshot.shipColumn] = 1 << snapshot.shipRow;
+	for (column = 0; column < COLS_NUM; column++) {
+		match->ships[CANDIDATES_LONG_SHIP][column] = snapshot.fleet[column] & ~match->ships[CANDIDATES_SHORT_SHIP][column];
+	}
+	for (ship = 0; ship < NUM_SHIPS; ship++) {
+		for (column = 0; column < COLS_NUM; column++) {
+			shipAfloat[column] = match->ships[ship][column] & snapshot.afloat[column];
+		}
+		match->shipCellsLeft[ship] = countBits(shipAfloat);
+	}
+	match->opponentSunk = snapshot.opponentSunk;
+#if TARGET_OVERLAY
+	candidatesRebuild(&match->candidates, snapshot.hitMatrix, snapshot.missMatrix, snapshot.opponentSunk);
+#endif
+	
+	memcpy(match->fleet, snapshot.fleet, COLS_NUM);
+	memcpy(match->afloat, snapshot.afloat, COLS_NUM);
+	memcpy(match->hitMatrix, snapshot.hitMatrix, COLS_NUM);
+	memcpy(match->missMatrix, snapshot.missMatrix, COLS_NUM);
+	match->isLastMoveHit = snapshot.isLastMoveHit;
+	match->turns = snapshot.turns;
+	match->yourHits = countBits(snapshot.hitMatrix);
+	match->opponentHits = countBits(snapshot.fleet) - countBits(snapshot.afloat);
+}
+
+
+
+static uint8_t resyncByte(void)
+/* Returns the byte sent while resuming. Its hash only covers what both 
+ * boards agree on (turns, hits by each player and whose turn it is), so
+ * the two boards send the same byte if their snapshots match. */
+{
+	uint8_t hits = countBits(snapshot.hitMatrix);
+	uint8_t hitsTaken = countBits(snapshot.fleet) - countBits(snapshot.afloat);
+	uint8_t shared[4];
+	
+	shared[0] = snapshot.turns;
+	shared[1] = snapshot.playerNum == 1 ? hits : hitsTaken;
+	shared[2] = snapshot.playerNum == 1 ? hitsTaken : hits;
+	shared[3] = snapshot.phase == PHASE_FIRE ? snapshot.playerNum : 3 - snapshot.playerNum;
+	return RESYNC_BYTE | (snapshotHash(shared, sizeof(shared)) & ~RESYNC_MASK);
+}
+
+
+
+void resyncEntry(void* data)
+/* Sets up the resume screen. Both boards must be resuming. */
+{
+	(void) data;
+	tinygl_general_init();
+	ledmat_init();
+	inputClear();
+	tinygl_text("RESUME ");
+}
+
+
+
+void resyncLoop(void* data)
+/* Checks that the other board has resumed the same match before going
+ * back to it. If the snapshots differ, or the button is pressed, a new
+ * match is started instead. */
+{
+	GameData* gameData = data;
+	Match* match = &gameData->match;
+	static uint8_t ticks = 0;
+	uint8_t byte = 0;
+	
+	ticks++;
+	if (ticks >= LOOP_RATE / RESYNC_RATE) {
+		ticks = 0;
+		match->sendBuffer = resyncByte();
+		match->readyToSend = true;
+	}
+	
+	while (LINK_READY() && gameData->phase == PHASE_RESYNC) {
+		byte = LINK_GETC();
+		TRACE_EVENT(TRACE_IR_RECEIVE, byte);
+		if ((byte & RESYNC_MASK) != RESYNC_BYTE) {
+			continue;
+		}
+		if (byte == resyncByte()) {
+			/* Answer in case the other board has not heard us yet. If this
+			 * is lost, resyncAnswered answers it again during the game. */
+			match->sendBuffer = byte;
+			match->readyToSend = true;
+			matchRestore(gameData);
+			match->resyncAnswer = byte;
+			gameData->phase = snapshot.phase;
+		} else {
+			gameData->phase = PHASE_PLACEMENT;
+		}
+	}
+	
+	if (inputEventGet() == INPUT_BUTTON) {
+		gameData->phase = PHASE_PLACEMENT;
+	}
+	PROFILE_CALL(PROFILE_TINYGL, tinygl_update());
+}
+
+
+
+/* The entry, loop and exit actions of each phase, indexed by the PHASE_* values */
+static const Phase phaseTable[] PROGMEM =
+{
+    {.entry = placementEntry, .run = placementLoop, .exit = placementExit},
+    {.entry = fireEntry, .run = fireLoop, .exit = 0},
+    {.entry = waitingEntry, .run = waitingLoop, .exit = 0},
+    {.entry = endEntry, .run = endLoop, .exit = 0},
+    {.entry = resyncEntry, .run = resyncLoop, .exit = 0},
+};
+
+
+
 void playLoop (void* data)
-/* Switches between game phases depending on the gameData->phase 
- * variable.*/
+/* Runs the current game phase, moving to a new phase first if 
+ * gameData->phase has changed. */
 {
     GameData* gameData = data;
+    uint8_t current = gameData->phaseMachine.current;
+    uint8_t phase = gameData->phase;
+    PROFILE_BEGIN(PROFILE_PHASE(phase));
+    TRACE_EVENT(TRACE_BEGIN, PROFILE_PHASE(phase));
+    idleAccount(phase);
+
+    if (phase != current) {
+        /* Measure the stack used by each phase separately */
+        memUsagePhaseStart(phase);
+        TRACE_EVENT(TRACE_PHASE, phase);
+        /* Every shot changes phase, so this saves the match after each one */
+        if (phase == PHASE_FIRE || phase == PHASE_WAITING || phase == PHASE_END) {
+            matchSave(gameData);
+        }
+    }
+    phaseMachineUpdate(&gameData->phaseMachine, phase, gameData);
+    snapshotWrite();
     
-    if (gameData->phase == 'P') {
-		placementLoop(gameData);
-	} else if (gameData->phase == 'F') {
-        fireLoop(gameData);
-    } else if (gameData->phase == 'W') {
-        waitingLoop(gameData);
-    } else if (gameData->phase == 'E') {
-        endLoop(gameData);
+    /* Nothing happens while waiting until the opponent shoots, so sleep 
+     * until the next task. If a shot arrives, read it in straight away. */
+    if (gameData->phase == PHASE_WAITING && idleSleep(PLAY_TASK)) {
+        communicationLoop(gameData);
     }
+    TRACE_EVENT(TRACE_END, PROFILE_PHASE(phase));
+    PROFILE_END();
 }
 
 
@@ -425,31 +1249,45 @@ void generalInit(void)
 /* A grouping of initialisation functions. */
 {
     system_init();
-    navswitch_init();
-    button_init();
-    ir_uart_init();
+    inputInit();
+    LINK_INIT();
 }
 
 
 
 int main (void)
 {    
-    playerNum = selectPlayer();
+    uint8_t phase = PHASE_PLACEMENT;
+    
+    /* Resume the last match if it had not finished, unless the button 
+     * is held down at start up */
+    generalInit();
+    inputSample();
+    if (snapshotLoad(&snapshot) && (snapshot.phase == PHASE_FIRE || snapshot.phase == PHASE_WAITING)
+        && !inputButtonDown()) {
+        playerNum = snapshot.playerNum;
+        phase = PHASE_RESYNC;
+    } else {
+        playerNum = selectPlayer();
+    }
     MusicObj musicObj;
     musicInit(&musicObj);
     Cursor cursor = {.column = DEFAULT_COL, .row = DEFAULT_ROW, .rowNum = (1 << DEFAULT_ROW)};
-    Cursor shipHull = {.column = DEFAULT_COL, .row = DEFAULT_ROW, .rowNum = (1 << DEFAULT_ROW)};
+    Ship ship = {.length = BOAT_LENGTH, .direction = HORIZONTAL, .centre = {.column = DEFAULT_COL, .row = DEFAULT_ROW, .rowNum = (1 << DEFAULT_ROW)}};
     generalInit();
-    GameData gameData = {.phase = 'P', .lastPhase = 'N', .cursor = &cursor, .shipHull = &shipHull, .isLastMoveHit = false, .yourHits = 0, .opponentHits = 0, .readyToReceive = false, .readyToSend = false};
+    GameData gameData = {.phase = phase, .cursor = &cursor, .ship = &ship, .music = &musicObj, .match = {0}};
+
+    phaseMachineInit(&gameData.phaseMachine, phaseTable);
 
     task_t tasks[] =
     {
         {.func = playLoop, .period = TASK_RATE / LOOP_RATE, .data=&gameData},
-        {.func = tweeterTask, .period = TASK_RATE / TWEETER_TASK_RATE, .data=&musicObj},
         {.func = tuneTask, .period = TASK_RATE / TUNE_TASK_RATE, .data=&musicObj},
         {.func = communicationLoop, .period = TASK_RATE / COMMUNICATION_RATE, .data=&gameData},
+        {.func = inputTask, .period = TASK_RATE / INPUT_TASK_RATE, .data=0},
     };
 
+    idleInit(tasks, NUM_TASKS);
     task_schedule (tasks, NUM_TASKS);
     return 0;
 }
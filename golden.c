@@ -0,0 +1,30 @@
+/** FILE: golden.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Tells simavr what to trace in the golden build, which
+ * plays the scenarios of script.c for golden_run: the ports that drive
+ * the LED matrix (PORTB and PORTC) and each byte sent over the IR link
+ * (GPIOR1, see scriptIrPutc). Only built into the golden build.
+ */
+
+#ifdef GOLDEN
+
+#include "system.h"
+#include <avr/io.h>
+#include "avr_mcu_section.h"
+
+/* VCD timestamps are in simulated time, so the period only sets how
+ * often simavr flushes the file. */
+#define GOLDEN_VCD_PERIOD 1000
+
+AVR_MCU(F_CPU, "atmega32u2");
+AVR_MCU_VCD_FILE("game_golden.vcd", GOLDEN_VCD_PERIOD);
+
+const struct avr_mmcu_vcd_trace_t goldenTrace[] _MMCU_ =
+{
+    { AVR_MCU_VCD_SYMBOL("ROWS"), .what = (void*) &PORTC, },
+    { AVR_MCU_VCD_SYMBOL("COLS"), .what = (void*) &PORTB, },
+    { AVR_MCU_VCD_SYMBOL("IR"), .what = (void*) &GPIOR1, },
+};
+
+#endif /* GOLDEN */
@@ -0,0 +1,689 @@
+/** FILE: golden_run.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host program that runs the scenarios of script.c through
+ * the golden build of the game ("make golden") and checks that the game
+ * still behaves the same. It runs the SCRIPT_NUM_SCENARIOS scenarios of
+ * script.c and -g scenarios generated from SCRIPT_GENERATED up (see
+ * script.h), several batches at once.
+ *
+ * By default the game is the native build (game_golden_native, see
+ * host/native.h), which plays each scenario in well under a 
+ * millisecond, so the 20000 generated scenarios run by default take 
+ * seconds. It plays a batch of scenarios for each run, written to
+ * golden_runs/native_N.txt, where N is the first scenario of the batch.
+ *
+ * With -s the game is the golden build for the board (game_golden.out)
+ * under simavr, run with the scenario number in EEPROM (see 
+ * SCRIPT_SCENARIO_ADDRESS) in a directory of its own, golden_runs/N. 
+ * Each scenario takes about a second, so none are generated unless -g
+ * is given. What the LED matrix ports went through (in order, without 
+ * repeats and ignoring when) and the bytes sent over the IR link are 
+ * each hashed.
+ *
+ * Timing is left out of the hashes, so that making the code faster does
+ * not change them. The two builds don't see the matrix the same way
+ * (the native build hashes columns and doesn't draw text), so each has
+ * its own golden file: golden.txt and golden_simavr.txt. The hashes are
+ * compared against the lines "scenario frameHash irHash" of the golden
+ * file, or written to it with -u. Generated scenarios are checked in 
+ * blocks of GOLDEN_BLOCK, as "first-last frameHash irHash" hashed from
+ * the hashes of each scenario of the block. "game_golden_native first 
+ * count" prints the hashes of single scenarios, to find the one that 
+ * changed. Lines for scenarios that are not run are ignored, so a
+ * smaller -g (in whole blocks) checks the first of them.
+ *
+ * A run still going after -w seconds (of wall-clock time) is killed and
+ * its scenarios are reported as FAILED.
+ *
+ * Usage: golden_run [-u] [-j jobs] [-w seconds] [-g count] [-s simavr]
+ *                   game_golden_native|game_golden.out golden.txt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "script.h"
+
+#define RUN_DIRECTORY "golden_runs"
+#define VCD_NAME "game_golden.vcd"
+#define EEPROM_NAME "eeprom.hex"
+#define LOG_NAME "simavr.log"
+#define MAX_LINE 256
+#define MAX_PATH 512
+
+/* How long a run may take before it is killed, and how often the
+ * running ones are checked */
+#define DEFAULT_WALL_SECONDS 60
+#define WATCH_US 10000
+
+/* Generated scenarios run by the native build unless -g says otherwise,
+ * the scenarios played by each run of it and the scenarios checked 
+ * together in the golden file */
+#define DEFAULT_GENERATED 20000
+#define NATIVE_BATCH 500
+#define GOLDEN_BLOCK 100
+
+/* Failures of each kind that are printed before the rest are counted */
+#define MAX_REPORTED 20
+
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+/* The traces written by golden.c */
+enum {TRACE_ROWS, TRACE_COLS, TRACE_IR, NUM_TRACES};
+
+
+
+/* The result of one scenario */
+typedef struct result_s
+{
+    bool isRun;             /* The game finished and its hashes were read */
+    bool isHung;            /* The run was killed for taking too long */
+    bool isStalled;         /* The native build gave up on it */
+    uint32_t frameHash;
+    uint32_t irHash;
+    unsigned long numFrames;
+    unsigned long numBytes;
+
+} Result;
+
+
+
+/* Scenarios played by one run of the game, results[first] onwards */
+typedef struct batch_s
+{
+    unsigned int first;
+    unsigned int count;
+    pid_t pid;
+    time_t started;
+
+} Batch;
+
+
+
+/* What is compared against the golden file: one scenario, or a block
+ * of generated ones */
+typedef struct check_s
+{
+    unsigned int first;     /* Scenario numbers */
+    unsigned int last;
+    uint32_t frameHash;
+    uint32_t irHash;
+    bool isInGolden;
+
+} Check;
+
+
+
+static uint32_t hashByte(uint32_t hash, uint8_t byte)
+/* Adds a byte to a 32-bit FNV-1a hash. */
+{
+    return (hash ^ byte) * FNV_PRIME;
+}
+
+
+
+static uint32_t hashWord(uint32_t hash, uint32_t word)
+/* Adds a 32-bit word, low byte first, to a 32-bit FNV-1a hash. */
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < 4; i++) {
+        hash = hashByte(hash, (uint8_t) (word >> (8 * i)));
+    }
+    return hash;
+}
+
+
+
+static unsigned int scenarioOf(unsigned int index)
+/* Returns the scenario number of results[index]: the scenarios of 
+ * script.c, then the generated ones. */
+{
+    return index < SCRIPT_NUM_SCENARIOS ? index : SCRIPT_GENERATED + index - SCRIPT_NUM_SCENARIOS;
+}
+
+
+
+static bool eepromWrite(const char* fileName, unsigned int scenario)
+/* Writes an Intel hex EEPROM image that selects scenario. */
+{
+    FILE* file = fopen(fileName, "w");
+    uint8_t low = (uint8_t) scenario;
+    uint8_t high = (uint8_t) (scenario >> 8);
+    uint8_t checksum = 0;
+
+    if (file == 0) {
+        return false;
+    }
+    checksum = -(2 + (SCRIPT_SCENARIO_ADDRESS >> 8) + (SCRIPT_SCENARIO_ADDRESS & 0xff) + low + high);
+    fprintf(file, ":02%04X00%02X%02X%02X\n", SCRIPT_SCENARIO_ADDRESS, low, high, checksum);
+    fprintf(file, ":00000001FF\n");
+    return fclose(file) == 0;
+}
+
+
+
+static void logOpen(const char* fileName)
+/* Sends the output of this process to fileName. */
+{
+    int log = open(fileName, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+
+    if (log >= 0) {
+        dup2(log, STDOUT_FILENO);
+        dup2(log, STDERR_FILENO);
+    }
+}
+
+
+
+static void nativeLogName(char* fileName, size_t size, const Batch* batch)
+/* Puts the name of the file a run of the native build writes to in 
+ * fileName. */
+{
+    snprintf(fileName, size, RUN_DIRECTORY "/native_%u.txt", scenarioOf(batch->first));
+}
+
+
+
+static pid_t batchStart(const char* simavr, const char* program, const Batch* batch)
+/* Starts the native build on the scenarios of batch, or if simavr is
+ * not 0, simavr on its one scenario in its own directory. Returns the
+ * process id, or -1 if it could not be started. */
+{
+    char directory[MAX_PATH];
+    char fileName[MAX_PATH];
+    char first[MAX_LINE];
+    char count[MAX_LINE];
+    unsigned int scenario = scenarioOf(batch->first);
+    pid_t pid = 0;
+
+    snprintf(directory, sizeof(directory), RUN_DIRECTORY "/%u", scenario);
+    mkdir(RUN_DIRECTORY, 0777);
+    if (simavr != 0) {
+        mkdir(directory, 0777);
+    }
+
+    pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+    if (simavr == 0) {
+        nativeLogName(fileName, sizeof(fileName), batch);
+        logOpen(fileName);
+        snprintf(first, sizeof(first), "%u", scenario);
+        snprintf(count, sizeof(count), "%u", batch->count);
+        execl(program, program, first, count, (char*) 0);
+        _exit(EXIT_FAILURE);
+    }
+    if (chdir(directory) != 0 || !eepromWrite(EEPROM_NAME, scenario)) {
+        _exit(EXIT_FAILURE);
+    }
+    logOpen(LOG_NAME);
+    remove(VCD_NAME);
+    execlp(simavr, simavr, "-ee", EEPROM_NAME, program, (char*) 0);
+    _exit(EXIT_FAILURE);
+}
+
+
+
+static void batchWait(Batch batches[], unsigned int numBatches, Result results[], unsigned long wallSeconds)
+/* Waits for one of the running batches (those with a process id) to 
+ * end, killing it if it has run for more than wallSeconds. Its process
+ * id is then cleared. */
+{
+    Batch* batch = 0;
+    unsigned int i = 0;
+    int status = 0;
+
+    while (true) {
+        for (batch = batches; batch < batches + numBatches; batch++) {
+            if (batch->pid <= 0) {
+                continue;
+            }
+            if (waitpid(batch->pid, &status, WNOHANG) == batch->pid) {
+                batch->pid = 0;
+                return;
+            }
+            if (wallSeconds > 0 && time(0) - batch->started > (time_t) wallSeconds) {
+                kill(batch->pid, SIGKILL);
+                waitpid(batch->pid, &status, 0);
+                for (i = batch->first; i < batch->first + batch->count; i++) {
+                    results[i].isHung = true;
+                }
+                batch->pid = 0;
+                return;
+            }
+        }
+        usleep(WATCH_US);
+    }
+}
+
+
+
+static void nativeRead(const Batch* batch, Result results[])
+/* Reads the hashes that a run of the native build printed for the
+ * scenarios of batch. */
+{
+    char fileName[MAX_PATH];
+    char line[MAX_LINE];
+    char word[MAX_LINE];
+    unsigned int scenario = 0;
+    unsigned int index = 0;
+    unsigned long frameHash = 0;
+    unsigned long irHash = 0;
+    unsigned long numFrames = 0;
+    unsigned long numBytes = 0;
+    FILE* file = 0;
+
+    nativeLogName(fileName, sizeof(fileName), batch);
+    file = fopen(fileName, "r");
+    if (file == 0) {
+        return;
+    }
+    while (fgets(line, sizeof(line), file) != 0) {
+        if (sscanf(line, "%u %s", &scenario, word) != 2) {
+            continue;
+        }
+        index = scenario < SCRIPT_GENERATED ? scenario : scenario - SCRIPT_GENERATED + SCRIPT_NUM_SCENARIOS;
+        if (index < batch->first || index >= batch->first + batch->count) {
+            continue;
+        }
+        if (strcmp(word, "stalled") == 0) {
+            results[index].isStalled = true;
+        } else if (sscanf(line, "%*u %lx %lx %lu %lu", &frameHash, &irHash, &numFrames, &numBytes) == 4) {
+            results[index].isRun = true;
+            results[index].frameHash = frameHash;
+            results[index].irHash = irHash;
+            results[index].numFrames = numFrames;
+            results[index].numBytes = numBytes;
+        }
+    }
+    fclose(file);
+}
+
+
+
+static bool traceRead(unsigned int scenario, Result* result)
+/* Hashes the trace that simavr wrote for scenario. Returns false if
+ * there is no trace. */
+{
+    static const char* names[NUM_TRACES] = {"ROWS", "COLS", "IR"};
+    char fileName[MAX_PATH];
+    char line[MAX_LINE];
+    char codes[NUM_TRACES][MAX_LINE] = {"", "", ""};
+    char varCode[MAX_LINE];
+    char name[MAX_LINE];
+    uint8_t values[NUM_TRACES] = {0};
+    uint8_t lastRows = 0;
+    uint8_t lastCols = 0;
+    bool isFrameChanged = false;
+    FILE* file = 0;
+    char* space = 0;
+    int trace = 0;
+
+    snprintf(fileName, sizeof(fileName), RUN_DIRECTORY "/%u/" VCD_NAME, scenario);
+    file = fopen(fileName, "r");
+    if (file == 0) {
+        return false;
+    }
+    result->frameHash = FNV_OFFSET;
+    result->irHash = FNV_OFFSET;
+
+    while (fgets(line, sizeof(line), file) != 0) {
+        if (strncmp(line, "$var", 4) == 0) {
+            if (sscanf(line, "$var %*s %*d %s %s", varCode, name) == 2) {
+                for (trace = 0; trace < NUM_TRACES; trace++) {
+                    if (strcmp(name, names[trace]) == 0) {
+                        strcpy(codes[trace], varCode);
+                    }
+                }
+            }
+        } else if (line[0] == '#' && isFrameChanged) {
+            /* Only the state the ports settle on at each time counts */
+            if (values[TRACE_ROWS] != lastRows || values[TRACE_COLS] != lastCols || result->numFrames == 0) {
+                lastRows = values[TRACE_ROWS];
+                lastCols = values[TRACE_COLS];
+                result->frameHash = hashByte(hashByte(result->frameHash, lastRows), lastCols);
+                result->numFrames++;
+            }
+            isFrameChanged = false;
+        } else if (line[0] == 'b' && (space = strchr(line, ' ')) != 0) {
+            space[1 + strcspn(space + 1, "\r\n")] = '\0';
+            for (trace = 0; trace < NUM_TRACES; trace++) {
+                if (strcmp(space + 1, codes[trace]) != 0) {
+                    continue;
+                }
+                values[trace] = (uint8_t) strtoul(line + 1, 0, 2);
+                if (trace == TRACE_IR) {
+                    /* scriptIrPutc writes 0 after each byte */
+                    if (values[trace] != 0) {
+                        result->irHash = hashByte(result->irHash, values[trace]);
+                        result->numBytes++;
+                    }
+                } else {
+                    isFrameChanged = true;
+                }
+            }
+        }
+    }
+    fclose(file);
+    return codes[TRACE_ROWS][0] != '\0' && codes[TRACE_COLS][0] != '\0' && codes[TRACE_IR][0] != '\0';
+}
+
+
+
+static unsigned int checksMake(const Result results[], unsigned int numScenarios, Check checks[])
+/* Makes the checks of the scenarios that were run: one for each of
+ * script.c, then one for each block of GOLDEN_BLOCK generated ones 
+ * (fewer for the last). Returns the number of checks. */
+{
+    unsigned int numChecks = 0;
+    unsigned int index = 0;
+    Check* check = 0;
+
+    for (index = 0; index < numScenarios; index++) {
+        if (index < SCRIPT_NUM_SCENARIOS || (index - SCRIPT_NUM_SCENARIOS) % GOLDEN_BLOCK == 0) {
+            check = &checks[numChecks];
+            numChecks++;
+            check->first = scenarioOf(index);
+            check->frameHash = FNV_OFFSET;
+            check->irHash = FNV_OFFSET;
+            check->isInGolden = false;
+        }
+        check->last = scenarioOf(index);
+        if (index < SCRIPT_NUM_SCENARIOS) {
+            check->frameHash = results[index].frameHash;
+            check->irHash = results[index].irHash;
+        } else {
+            check->frameHash = hashWord(check->frameHash, results[index].frameHash);
+            check->irHash = hashWord(check->irHash, results[index].irHash);
+        }
+    }
+    return numChecks;
+}
+
+
+
+static void checkName(char* name, size_t size, const Check* check)
+/* Puts how the golden file names check in name. */
+{
+    if (check->first == check->last) {
+        snprintf(name, size, "%u", check->first);
+    } else {
+        snprintf(name, size, "%u-%u", check->first, check->last);
+    }
+}
+
+
+
+static bool goldenCompare(const char* fileName, Check checks[], unsigned int numChecks, bool isSame[])
+/* Compares checks against the golden file, setting isInGolden for
+ * those in it and isSame[2 * i] and isSame[2 * i + 1] if check i has
+ * the same frames and IR bytes. Returns false if the file can't be 
+ * read. */
+{
+    FILE* file = fopen(fileName, "r");
+    char line[MAX_LINE];
+    char name[MAX_LINE];
+    char goldenName[MAX_LINE];
+    unsigned long frameHash = 0;
+    unsigned long irHash = 0;
+    unsigned int i = 0;
+
+    if (file == 0) {
+        return false;
+    }
+    while (fgets(line, sizeof(line), file) != 0) {
+        if (line[0] == '#' || sscanf(line, "%s %lx %lx", goldenName, &frameHash, &irHash) != 3) {
+            continue;
+        }
+        for (i = 0; i < numChecks; i++) {
+            checkName(name, sizeof(name), &checks[i]);
+            if (strcmp(name, goldenName) == 0) {
+                checks[i].isInGolden = true;
+                isSame[2 * i] = checks[i].frameHash == frameHash;
+                isSame[2 * i + 1] = checks[i].irHash == irHash;
+            }
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+
+
+static bool goldenWrite(const char* fileName, const Check checks[], unsigned int numChecks)
+/* Writes the hashes of every check to the golden file. */
+{
+    FILE* file = fopen(fileName, "w");
+    char name[MAX_LINE];
+    unsigned int i = 0;
+
+    if (file == 0) {
+        return false;
+    }
+    fprintf(file, "# scenario frameHash irHash, or first-last for a block of generated scenarios, "
+            "written by golden_run -u\n");
+    for (i = 0; i < numChecks; i++) {
+        checkName(name, sizeof(name), &checks[i]);
+        fprintf(file, "%s %08lx %08lx\n", name, (unsigned long) checks[i].frameHash,
+                (unsigned long) checks[i].irHash);
+    }
+    return fclose(file) == 0;
+}
+
+
+
+static void reportFailure(unsigned int* numReported, const char* format, unsigned int scenario, const char* detail)
+/* Prints a failure, unless MAX_REPORTED have already been printed. */
+{
+    if (*numReported < MAX_REPORTED) {
+        printf(format, scenario, detail);
+    }
+    (*numReported)++;
+}
+
+
+
+int main(int argc, char* argv[])
+{
+    Result* results = 0;
+    Batch* batches = 0;
+    Check* checks = 0;
+    bool* isSame = 0;
+    char program[PATH_MAX];
+    char log[MAX_PATH];
+    char name[MAX_LINE];
+    char reason[MAX_PATH + MAX_LINE];
+    const char* simavr = 0;
+    bool isUpdate = false;
+    long numJobs = sysconf(_SC_NPROCESSORS_ONLN);
+    long numGenerated = -1;
+    unsigned long wallSeconds = DEFAULT_WALL_SECONDS;
+    unsigned int numScenarios = 0;
+    unsigned int numBatches = 0;
+    unsigned int numChecks = 0;
+    unsigned int numReported = 0;
+    unsigned int numFailed = 0;
+    unsigned int index = 0;
+    unsigned int i = 0;
+    struct timespec start;
+    struct timespec end;
+    int numRunning = 0;
+    int option = 0;
+
+    while ((option = getopt(argc, argv, "uj:w:g:s:")) != -1) {
+        if (option == 'u') {
+            isUpdate = true;
+        } else if (option == 'j') {
+            numJobs = strtol(optarg, 0, 10);
+        } else if (option == 'w') {
+            wallSeconds = strtoul(optarg, 0, 10);
+        } else if (option == 'g') {
+            numGenerated = strtol(optarg, 0, 10);
+        } else if (option == 's') {
+            simavr = optarg;
+        }
+    }
+    if (optind != argc - 2) {
+        fprintf(stderr, "usage: %s [-u] [-j jobs] [-w seconds] [-g count] [-s simavr] "
+                "game_golden_native|game_golden.out golden.txt\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    /* Don't spend time running the scenarios with nothing to check them
+     * against */
+    if (!isUpdate && access(argv[optind + 1], F_OK) != 0) {
+        fprintf(stderr, "%s: no golden file, run \"make golden-update\" first\n", argv[optind + 1]);
+        return EXIT_FAILURE;
+    }
+    /* simavr is run from the scenario's directory */
+    if (realpath(argv[optind], program) == 0) {
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+    }
+    if (numJobs < 1) {
+        numJobs = 1;
+    }
+    if (numGenerated < 0) {
+        numGenerated = simavr == 0 ? DEFAULT_GENERATED : 0;
+    }
+    if (numGenerated > SCRIPT_ERASED - SCRIPT_GENERATED) {
+        numGenerated = SCRIPT_ERASED - SCRIPT_GENERATED;
+    }
+    numScenarios = SCRIPT_NUM_SCENARIOS + (unsigned int) numGenerated;
+
+    /* Far more than are needed */
+    results = calloc(numScenarios, sizeof(Result));
+    batches = calloc(numScenarios, sizeof(Batch));
+    checks = calloc(numScenarios, sizeof(Check));
+    isSame = calloc(2 * numScenarios, sizeof(bool));
+    if (results == 0 || batches == 0 || checks == 0 || isSame == 0) {
+        perror("calloc");
+        return EXIT_FAILURE;
+    }
+
+    /* simavr plays one scenario a run. The scenarios of script.c are 
+     * not numbered on from the generated ones, so they are a batch of
+     * their own. */
+    for (index = 0; index < numScenarios; index += batches[numBatches - 1].count) {
+        batches[numBatches].first = index;
+        if (simavr != 0) {
+            batches[numBatches].count = 1;
+        } else if (index < SCRIPT_NUM_SCENARIOS) {
+            batches[numBatches].count = SCRIPT_NUM_SCENARIOS - index;
+        } else {
+            batches[numBatches].count = numScenarios - index < NATIVE_BATCH ? numScenarios - index : NATIVE_BATCH;
+        }
+        numBatches++;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < numBatches; i++) {
+        if (numRunning == numJobs) {
+            batchWait(batches, numBatches, results, wallSeconds);
+            numRunning--;
+        }
+        batches[i].pid = batchStart(simavr, program, &batches[i]);
+        if (batches[i].pid < 0) {
+            perror("fork");
+            return EXIT_FAILURE;
+        }
+        batches[i].started = time(0);
+        numRunning++;
+    }
+    while (numRunning > 0) {
+        batchWait(batches, numBatches, results, wallSeconds);
+        numRunning--;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    for (i = 0; i < numBatches; i++) {
+        if (simavr == 0) {
+            nativeRead(&batches[i], results);
+            nativeLogName(log, sizeof(log), &batches[i]);
+        } else {
+            snprintf(log, sizeof(log), RUN_DIRECTORY "/%u/" LOG_NAME, scenarioOf(batches[i].first));
+        }
+        for (index = batches[i].first; index < batches[i].first + batches[i].count; index++) {
+            if (simavr != 0 && !results[index].isHung) {
+                results[index].isRun = traceRead(scenarioOf(index), &results[index]);
+            }
+            if (results[index].isHung) {
+                snprintf(reason, sizeof(reason), "killed after %lu s, see %s", wallSeconds, log);
+                reportFailure(&numReported, "scenario %u: FAILED (%s)\n", scenarioOf(index), reason);
+            } else if (results[index].isStalled) {
+                reportFailure(&numReported, "scenario %u: FAILED (%s)\n", scenarioOf(index),
+                              "still running after the time allowed");
+            } else if (!results[index].isRun) {
+                reportFailure(&numReported, "scenario %u: no result, see %s\n", scenarioOf(index), log);
+            }
+            if (!results[index].isRun) {
+                numFailed++;
+            }
+        }
+    }
+    if (numReported > MAX_REPORTED) {
+        printf("... and %u more\n", numReported - MAX_REPORTED);
+    }
+    printf("%u scenarios run in %.2f s\n", numScenarios,
+           (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
+    if (numFailed > 0) {
+        printf("%u of %u scenarios failed to run\n", numFailed, numScenarios);
+        return EXIT_FAILURE;
+    }
+
+    numChecks = checksMake(results, numScenarios, checks);
+    if (isUpdate) {
+        if (!goldenWrite(argv[optind + 1], checks, numChecks)) {
+            perror(argv[optind + 1]);
+            return EXIT_FAILURE;
+        }
+        printf("%u scenarios written to %s\n", numScenarios, argv[optind + 1]);
+        return EXIT_SUCCESS;
+    }
+
+    if (!goldenCompare(argv[optind + 1], checks, numChecks, isSame)) {
+        perror(argv[optind + 1]);
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < numChecks; i++) {
+        const Check* check = &checks[i];
+        bool isFramesSame = isSame[2 * i];
+        bool isIrSame = isSame[2 * i + 1];
+
+        checkName(name, sizeof(name), check);
+        if (!check->isInGolden) {
+            printf("%s %s: FAILED (not in %s, run \"make golden-update\")\n",
+                   check->first == check->last ? "scenario" : "scenarios", name, argv[optind + 1]);
+            numFailed++;
+        } else if (check->first == check->last) {
+            /* The checks of the scenarios of script.c come first, in order */
+            printf("scenario %s: %s (%lu frames%s, %lu IR bytes%s)\n", name,
+                   isFramesSame && isIrSame ? "ok" : "FAILED",
+                   results[i].numFrames, isFramesSame ? "" : " differ",
+                   results[i].numBytes, isIrSame ? "" : " differ");
+        } else if (!isFramesSame || !isIrSame) {
+            printf("scenarios %s: FAILED (%s%s%s)\n", name, isFramesSame ? "" : "frames differ",
+                   isFramesSame || isIrSame ? "" : ", ", isIrSame ? "" : "IR bytes differ");
+        }
+        if (check->isInGolden && (!isFramesSame || !isIrSame)) {
+            numFailed++;
+        }
+    }
+    if (numGenerated > 0 && numFailed == 0) {
+        printf("scenarios %u-%u (generated): ok\n", SCRIPT_GENERATED, scenarioOf(numScenarios - 1));
+    }
+    printf("%u of %u checks failed\n", numFailed, numChecks);
+    return numFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
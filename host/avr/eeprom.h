@@ -0,0 +1,34 @@
+/** FILE: host/avr/eeprom.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for avr/eeprom.h, for the native build of
+ * the game. The EEPROM is nativeEeprom (see native.h) and writes finish
+ * straight away.
+ */
+
+
+#ifndef AVR_EEPROM_H
+#define AVR_EEPROM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define eeprom_is_ready() 1
+
+
+
+uint8_t eeprom_read_byte(const uint8_t* address);
+
+
+
+uint16_t eeprom_read_word(const uint16_t* address);
+
+
+
+void eeprom_read_block(void* destination, const void* source, size_t length);
+
+
+
+void eeprom_update_byte(uint8_t* address, uint8_t value);
+
+#endif /* AVR_EEPROM_H */
@@ -0,0 +1,24 @@
+/** FILE: host/avr/interrupt.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for avr/interrupt.h. An ISR is an ordinary
+ * function named after its vector, which the host tool calls when the
+ * interrupt would fire. sei and cli only set the I bit of SREG, which
+ * the native build checks when the CPU sleeps (see native.c).
+ */
+
+
+#ifndef AVR_INTERRUPT_H
+#define AVR_INTERRUPT_H
+
+#include "io.h"
+
+#define ISR(VECTOR) void VECTOR(void)
+#define sei() (SREG |= 1 << SREG_I)
+#define cli() (SREG &= ~(1 << SREG_I))
+
+void TIMER1_COMPA_vect(void);
+void TIMER1_COMPB_vect(void);
+void USART1_RX_vect(void);
+
+#endif /* AVR_INTERRUPT_H */
@@ -0,0 +1,34 @@
+/** FILE: host/avr/io.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for the timer 1, USART, port and status
+ * registers used by tone.c and idle.c. They are plain variables (see 
+ * port.c) that the host tool or native build drives like the hardware
+ * would.
+ */
+
+
+#ifndef AVR_IO_H
+#define AVR_IO_H
+
+#include <stdint.h>
+
+#define OCIE1A 1
+#define OCIE1B 2
+#define OCF1A 1
+#define OCF1B 2
+#define RXCIE1 7
+#define SREG_I 7
+
+extern volatile uint8_t TIMSK1;
+extern volatile uint8_t TIFR1;
+extern volatile uint16_t TCNT1;
+extern volatile uint16_t OCR1A;
+extern volatile uint16_t OCR1B;
+extern volatile uint8_t UCSR1B;
+extern volatile uint8_t SREG;
+extern volatile uint8_t PORTB;
+extern volatile uint8_t PORTC;
+extern volatile uint8_t PORTD;
+
+#endif /* AVR_IO_H */
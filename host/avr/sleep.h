@@ -0,0 +1,22 @@
+/** FILE: host/avr/sleep.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for avr/sleep.h, for the native build of
+ * the game. Sleeping moves simulated time on to the next interrupt, or
+ * stops the board if interrupts are off (see nativeSleep in native.h).
+ */
+
+
+#ifndef AVR_SLEEP_H
+#define AVR_SLEEP_H
+
+#define SLEEP_MODE_IDLE 0
+
+#define set_sleep_mode(MODE)
+#define sleep_enable()
+#define sleep_disable()
+#define sleep_cpu() nativeSleep()
+
+void nativeSleep(void);
+
+#endif /* AVR_SLEEP_H */
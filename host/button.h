@@ -0,0 +1,19 @@
+/** FILE: host/button.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for the UCFK button.h. The native build
+ * (see native.h) is always played by a script (see input.c), so the
+ * button is only initialised.
+ */
+
+
+#ifndef BUTTON_H
+#define BUTTON_H
+
+#include "system.h"
+
+
+
+void button_init(void);
+
+#endif /* BUTTON_H */
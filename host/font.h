@@ -0,0 +1,20 @@
+/** FILE: host/font.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for the UCFK font.h. The native build (see
+ * native.h) does not draw text, so a font is only its size.
+ */
+
+
+#ifndef FONT_H
+#define FONT_H
+
+#include "system.h"
+
+typedef struct font_struct
+{
+    uint8_t width;
+    uint8_t height;
+} font_t;
+
+#endif /* FONT_H */
@@ -0,0 +1,15 @@
+/** FILE: host/font5x7_1.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for the UCFK font5x7_1.h (see font.h).
+ */
+
+
+#ifndef FONT5X7_1_H
+#define FONT5X7_1_H
+
+#include "font.h"
+
+static font_t font5x7_1 = {5, 7};
+
+#endif /* FONT5X7_1_H */
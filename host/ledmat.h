@@ -0,0 +1,25 @@
+/** FILE: host/ledmat.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for the UCFK ledmat.h, for the native 
+ * build of the game (see native.h). The columns are kept in memory 
+ * and every change to what the matrix shows is recorded.
+ */
+
+
+#ifndef LEDMAT_H
+#define LEDMAT_H
+
+#include "system.h"
+
+
+
+void ledmat_init(void);
+/* Turns every LED off. */
+
+
+
+void ledmat_display_column(uint8_t pattern, uint8_t col);
+/* Shows pattern (bit i for row i) in column col. */
+
+#endif /* LEDMAT_H */
@@ -0,0 +1,45 @@
+/** FILE: host/mem_usage.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Stand-in for mem_usage.c in the native build of the game
+ * (see native.h). The host has no painted stack to look at, so nothing
+ * is measured and everything reads as 0.
+ */
+
+#include "mem_usage.h"
+
+
+
+uint16_t memUsageStatic(void)
+{
+    return 0;
+}
+
+
+
+uint16_t memUsageStackFree(void)
+{
+    return 0;
+}
+
+
+
+uint16_t memUsageStackPeak(void)
+{
+    return 0;
+}
+
+
+
+void memUsagePhaseStart(uint8_t phase)
+{
+    (void) phase;
+}
+
+
+
+uint16_t memUsagePhasePeak(uint8_t phase)
+{
+    (void) phase;
+    return 0;
+}
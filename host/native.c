@@ -0,0 +1,311 @@
+/** FILE: host/native.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: The simulated board behind the native build of the
+ * game: its clock, scheduler, LED matrix, text display, EEPROM and
+ * sleep. See native.h.
+ */
+
+#include "native.h"
+#include "system.h"
+#include "timer.h"
+#include "task.h"
+#include "pacer.h"
+#include "ledmat.h"
+#include "tinygl.h"
+#include "navswitch.h"
+#include "button.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/eeprom.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+/* Simulated time taken by each read of the timer */
+#define TICKS_PER_READ 1
+
+/* Hashed before a text, so that it can't look like a set of columns */
+#define TEXT_MARKER 0xff
+
+uint32_t nativeTicks = 0;
+uint8_t nativeEeprom[NATIVE_EEPROM_SIZE];
+NativeTrace nativeTrace;
+
+static uint8_t columns[LEDMAT_COLS_NUM];
+
+static uint32_t pacerPeriod = 0;
+static uint32_t pacerNext = 0;
+
+
+
+static uint32_t hashByte(uint32_t hash, uint8_t byte)
+/* Adds a byte to a 32-bit FNV-1a hash. */
+{
+    return (hash ^ byte) * FNV_PRIME;
+}
+
+
+
+static void advance(uint32_t ticks)
+/* Moves simulated time on. */
+{
+    nativeTicks += ticks;
+    TCNT1 = (uint16_t) nativeTicks;
+    nativeTime();
+}
+
+
+
+void nativeReset(void)
+/* Puts the board as it is at power up: the time and the trace back to
+ * the start and the EEPROM erased. */
+{
+    nativeTicks = 0;
+    TCNT1 = 0;
+    TIMSK1 = 0;
+    UCSR1B = 0;
+    SREG = 0;
+    memset(nativeEeprom, 0xff, sizeof(nativeEeprom));
+    memset(columns, 0, sizeof(columns));
+    nativeTrace.frameHash = FNV_OFFSET;
+    nativeTrace.irHash = FNV_OFFSET;
+    nativeTrace.numFrames = 0;
+    nativeTrace.numBytes = 0;
+}
+
+
+
+void nativeIrSent(uint8_t byte)
+/* Records a byte sent over the IR link (see scriptIrPutc). */
+{
+    nativeTrace.irHash = hashByte(nativeTrace.irHash, byte);
+    nativeTrace.numBytes++;
+}
+
+
+
+void nativeSleep(void)
+/* Sleeps until the timer 1 compare A interrupt, which is the only one
+ * modelled, then runs it. With interrupts off the board stops. */
+{
+    uint16_t ticks = 0;
+
+    if (!(SREG & (1 << SREG_I))) {
+        nativeStopped();
+        exit(EXIT_FAILURE);
+    }
+    if (!(TIMSK1 & (1 << OCIE1A))) {
+        fprintf(stderr, "native: asleep with nothing to wake it\n");
+        abort();
+    }
+    /* A compare is only seen when the count next reaches OCR1A */
+    ticks = OCR1A - TCNT1;
+    advance(ticks == 0 ? UINT16_MAX + 1u : ticks);
+    TIFR1 |= 1 << OCF1A;
+    TIMER1_COMPA_vect();
+}
+
+
+
+void system_init(void)
+{
+}
+
+
+
+timer_tick_t timer_get(void)
+/* Returns the simulated timer 1 count. */
+{
+    advance(TICKS_PER_READ);
+    return TCNT1;
+}
+
+
+
+void task_schedule(task_t* tasks, uint8_t num_tasks)
+/* Runs each task every period ticks, for good. Simulated time jumps
+ * ahead to the next task that is due. */
+{
+    timer_tick_t now = timer_get();
+    task_t* next = 0;
+    uint8_t i = 0;
+
+    for (i = 0; i < num_tasks; i++) {
+        tasks[i].reschedule = now;
+    }
+    while (true) {
+        next = &tasks[0];
+        for (i = 1; i < num_tasks; i++) {
+            if ((int16_t) (tasks[i].reschedule - next->reschedule) < 0) {
+                next = &tasks[i];
+            }
+        }
+        if ((int16_t) (next->reschedule - now) > 0) {
+            advance((timer_tick_t) (next->reschedule - now));
+        }
+        next->reschedule += next->period;
+        next->func(next->data);
+        now = timer_get();
+    }
+}
+
+
+
+void pacer_init(uint16_t pacer_rate)
+/* Sets how many times a second pacer_wait returns. */
+{
+    pacerPeriod = TIMER_RATE / pacer_rate;
+    pacerNext = nativeTicks + pacerPeriod;
+}
+
+
+
+void pacer_wait(void)
+/* Moves simulated time on to the next pacer period. */
+{
+    if ((int32_t) (pacerNext - nativeTicks) > 0) {
+        advance(pacerNext - nativeTicks);
+    }
+    pacerNext += pacerPeriod;
+}
+
+
+
+static void frameRecord(void)
+/* Records what the matrix shows now. */
+{
+    uint8_t col = 0;
+
+    for (col = 0; col < LEDMAT_COLS_NUM; col++) {
+        nativeTrace.frameHash = hashByte(nativeTrace.frameHash, columns[col]);
+    }
+    nativeTrace.numFrames++;
+}
+
+
+
+void ledmat_init(void)
+/* Turns every LED off. */
+{
+    static const uint8_t off[LEDMAT_COLS_NUM] = {0};
+
+    if (memcmp(columns, off, sizeof(columns)) != 0) {
+        memset(columns, 0, sizeof(columns));
+        frameRecord();
+    }
+}
+
+
+
+void ledmat_display_column(uint8_t pattern, uint8_t col)
+/* Shows pattern (bit i for row i) in column col. */
+{
+    if (col < LEDMAT_COLS_NUM && columns[col] != pattern) {
+        columns[col] = pattern;
+        frameRecord();
+    }
+}
+
+
+
+void tinygl_init(uint16_t update_rate)
+{
+    (void) update_rate;
+}
+
+
+
+void tinygl_font_set(font_t* font)
+{
+    (void) font;
+}
+
+
+
+void tinygl_text_speed_set(uint8_t speed)
+{
+    (void) speed;
+}
+
+
+
+void tinygl_text_mode_set(tinygl_text_mode_t mode)
+{
+    (void) mode;
+}
+
+
+
+void tinygl_text(const char* string)
+/* Records string as what the matrix shows. */
+{
+    nativeTrace.frameHash = hashByte(nativeTrace.frameHash, TEXT_MARKER);
+    while (*string != '\0') {
+        nativeTrace.frameHash = hashByte(nativeTrace.frameHash, (uint8_t) *string);
+        string++;
+    }
+    nativeTrace.numFrames++;
+}
+
+
+
+void tinygl_update(void)
+{
+}
+
+
+
+void navswitch_init(void)
+{
+}
+
+
+
+void button_init(void)
+{
+}
+
+
+
+uint8_t eeprom_read_byte(const uint8_t* address)
+{
+    size_t offset = (size_t) address;
+
+    return offset < NATIVE_EEPROM_SIZE ? nativeEeprom[offset] : 0xff;
+}
+
+
+
+uint16_t eeprom_read_word(const uint16_t* address)
+{
+    const uint8_t* bytes = (const uint8_t*) address;
+
+    return eeprom_read_byte(bytes) | (eeprom_read_byte(bytes + 1) << 8);
+}
+
+
+
+void eeprom_read_block(void* destination, const void* source, size_t length)
+{
+    size_t i = 0;
+
+    for (i = 0; i < length; i++) {
+        ((uint8_t*) destination)[i] = eeprom_read_byte((const uint8_t*) source + i);
+    }
+}
+
+
+
+void eeprom_update_byte(uint8_t* address, uint8_t value)
+{
+    size_t offset = (size_t) address;
+
+    if (offset < NATIVE_EEPROM_SIZE) {
+        nativeEeprom[offset] = value;
+    }
+}
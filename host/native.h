@@ -0,0 +1,99 @@
+/** FILE: host/native.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: The native build of the game: all of it built for the
+ * host (with NATIVE defined), with the stand-ins in this directory in
+ * place of the UCFK drivers and the AVR registers. It is always played
+ * by a script (see script.h) and runs a scripted game in a millisecond
+ * or so, where simavr takes about a second.
+ *
+ * The board runs on simulated time, counted in timer ticks. Reading
+ * the timer takes one tick, so that busy-waits (e.g recordShot waiting
+ * for a reply) move time on. The scheduler, the pacer and sleeping jump
+ * straight to the time they would wake at. Nothing else takes any time,
+ * so tasks never overrun. The piezo and the IR receive interrupt are
+ * not modelled.
+ *
+ * What the LED matrix shows and the bytes sent over the IR link are
+ * hashed into nativeTrace, as the golden build does under simavr (see
+ * golden_run.c), except that text is not drawn: each text shown counts
+ * as one change of the matrix.
+ *
+ * A program that runs the native build (native_golden.c, or link_run
+ * for the link build) calls nativeReset, puts the scenario number in
+ * nativeEeprom and calls gameMain. It provides nativeTime and
+ * nativeStopped, and in the link build (SIMLINK) the nativeLink
+ * functions too.
+ */
+
+
+#ifndef NATIVE_H
+#define NATIVE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define NATIVE_EEPROM_SIZE 1024
+
+/* What the game has done, hashed */
+typedef struct native_trace_s
+{
+    uint32_t frameHash;         /* Every change of what the matrix shows */
+    uint32_t irHash;            /* Every byte sent */
+    unsigned long numFrames;
+    unsigned long numBytes;
+
+} NativeTrace;
+
+/* Simulated time since nativeReset, in timer ticks */
+extern uint32_t nativeTicks;
+
+extern uint8_t nativeEeprom[NATIVE_EEPROM_SIZE];
+extern NativeTrace nativeTrace;
+
+
+
+int gameMain(void);
+/* The game's main (game.c is built with -Dmain=gameMain). Never returns. */
+
+
+
+void nativeReset(void);
+/* Puts the board as it is at power up: the time and the trace back to
+ * the start and the EEPROM erased. */
+
+
+
+void nativeIrSent(uint8_t byte);
+/* Records a byte sent over the IR link (see scriptIrPutc). */
+
+
+
+/* Provided by the program running the board */
+
+void nativeTime(void);
+/* Called each time simulated time moves on. */
+
+
+
+void nativeStopped(void);
+/* Called when the game stops the CPU (e.g at the end of the script).
+ * Must not return. */
+
+
+
+bool nativeLinkReady(void);
+/* Returns true if the other board has sent a byte that has not been
+ * read. Only used by the link build. */
+
+
+
+uint8_t nativeLinkGetc(void);
+/* Returns the next byte sent by the other board. */
+
+
+
+void nativeLinkPutc(uint8_t byte);
+/* Sends a byte to the other board. */
+
+#endif /* NATIVE_H */
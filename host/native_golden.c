@@ -0,0 +1,108 @@
+/** FILE: host/native_golden.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Plays scenarios of script.c through the native golden
+ * build of the game (see native.h) for golden_run. Each scenario is
+ * played in a process of its own, forked from this one, so that it
+ * starts from the game's power up state. For each it prints the line
+ * "scenario frameHash irHash numFrames numBytes", or "scenario stalled"
+ * if it has not ended after MAX_SECONDS of simulated time, or "scenario
+ * crashed".
+ *
+ * Usage: game_golden_native first count
+ */
+
+#include "native.h"
+#include "script.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/* Simulated time a scenario may take. The longest in script.c takes
+ * under 30 s. */
+#define MAX_SECONDS 120
+
+static unsigned long scenario = 0;
+
+
+
+void nativeTime(void)
+/* Gives up on a scenario that has run too long. */
+{
+    if (nativeTicks > (uint32_t) MAX_SECONDS * TIMER_RATE) {
+        printf("%lu stalled\n", scenario);
+        fflush(stdout);
+        _exit(EXIT_FAILURE);
+    }
+}
+
+
+
+void nativeStopped(void)
+/* Prints the hashes of the scenario that has just ended. */
+{
+    printf("%lu %08lx %08lx %lu %lu\n", scenario, (unsigned long) nativeTrace.frameHash,
+           (unsigned long) nativeTrace.irHash, nativeTrace.numFrames, nativeTrace.numBytes);
+    fflush(stdout);
+    _exit(EXIT_SUCCESS);
+}
+
+
+
+bool nativeLinkReady(void)
+/* The golden build has no link to another board */
+{
+    return false;
+}
+
+
+
+uint8_t nativeLinkGetc(void)
+{
+    return 0;
+}
+
+
+
+void nativeLinkPutc(uint8_t byte)
+{
+    (void) byte;
+}
+
+
+
+int main(int argc, char* argv[])
+{
+    unsigned long first = 0;
+    unsigned long count = 0;
+    pid_t pid = 0;
+    int status = 0;
+
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s first count\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    first = strtoul(argv[1], 0, 10);
+    count = strtoul(argv[2], 0, 10);
+
+    for (scenario = first; scenario < first + count; scenario++) {
+        fflush(stdout);
+        pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            return EXIT_FAILURE;
+        }
+        if (pid == 0) {
+            nativeReset();
+            nativeEeprom[SCRIPT_SCENARIO_ADDRESS] = (uint8_t) scenario;
+            nativeEeprom[SCRIPT_SCENARIO_ADDRESS + 1] = (uint8_t) (scenario >> 8);
+            gameMain();
+            _exit(EXIT_FAILURE);
+        }
+        if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status)) {
+            printf("%lu crashed\n", scenario);
+        }
+    }
+    return EXIT_SUCCESS;
+}
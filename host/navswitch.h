@@ -0,0 +1,19 @@
+/** FILE: host/navswitch.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for the UCFK navswitch.h. The native build
+ * (see native.h) is always played by a script (see input.c), so the 
+ * navswitch is only initialised.
+ */
+
+
+#ifndef NAVSWITCH_H
+#define NAVSWITCH_H
+
+#include "system.h"
+
+
+
+void navswitch_init(void);
+
+#endif /* NAVSWITCH_H */
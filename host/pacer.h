@@ -0,0 +1,24 @@
+/** FILE: host/pacer.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for the UCFK pacer.h, for the native build
+ * of the game (see native.h).
+ */
+
+
+#ifndef PACER_H
+#define PACER_H
+
+#include "system.h"
+
+
+
+void pacer_init(uint16_t pacer_rate);
+/* Sets how many times a second pacer_wait returns. */
+
+
+
+void pacer_wait(void);
+/* Moves simulated time on to the next pacer period. */
+
+#endif /* PACER_H */
@@ -0,0 +1,46 @@
+/** FILE: host/pio.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for the UCFK pio.h. Only output pins are
+ * modelled, as bits of the port registers in port.c.
+ */
+
+
+#ifndef PIO_H
+#define PIO_H
+
+#include "system.h"
+
+typedef uint8_t pio_t;
+
+/* A pin is its port in the top bits and its bit number in the bottom 3 */
+#define PORT_B 0
+#define PORT_C 1
+#define PORT_D 2
+#define PIO_DEFINE(PORT, PIN) ((pio_t) (((PORT) << 3) | (PIN)))
+
+typedef enum pio_config_enum {PIO_INPUT, PIO_PULLUP, PIO_OUTPUT_LOW, PIO_OUTPUT_HIGH} pio_config_t;
+
+
+
+bool pio_config_set(pio_t pio, pio_config_t config);
+/* Sets the pin low or high for the output configs. */
+
+
+
+void pio_output_low(pio_t pio);
+
+
+
+void pio_output_high(pio_t pio);
+
+
+
+void pio_output_toggle(pio_t pio);
+
+
+
+bool pio_output_get(pio_t pio);
+/* Returns the level the pin is driven to. */
+
+#endif /* PIO_H */
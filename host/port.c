@@ -0,0 +1,73 @@
+/** FILE: host/port.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: The registers and pins behind the host stand-ins in
+ * this directory, which let host tools (see music_render.c) run the
+ * game's own tone.c instead of a copy of it.
+ */
+
+#include "pio.h"
+#include <avr/io.h>
+
+volatile uint8_t TIMSK1 = 0;
+volatile uint8_t TIFR1 = 0;
+volatile uint16_t TCNT1 = 0;
+volatile uint16_t OCR1A = 0;
+volatile uint16_t OCR1B = 0;
+volatile uint8_t UCSR1B = 0;
+volatile uint8_t SREG = 0;
+volatile uint8_t PORTB = 0;
+volatile uint8_t PORTC = 0;
+volatile uint8_t PORTD = 0;
+
+
+
+static volatile uint8_t* portOf(pio_t pio)
+/* Returns the port register of a pin. */
+{
+    static volatile uint8_t* const ports[] = {&PORTB, &PORTC, &PORTD};
+
+    return ports[pio >> 3];
+}
+
+
+
+bool pio_config_set(pio_t pio, pio_config_t config)
+/* Sets the pin low or high for the output configs. */
+{
+    if (config == PIO_OUTPUT_HIGH) {
+        pio_output_high(pio);
+    } else if (config == PIO_OUTPUT_LOW) {
+        pio_output_low(pio);
+    }
+    return true;
+}
+
+
+
+void pio_output_low(pio_t pio)
+{
+    *portOf(pio) &= ~(1 << (pio & 7));
+}
+
+
+
+void pio_output_high(pio_t pio)
+{
+    *portOf(pio) |= 1 << (pio & 7);
+}
+
+
+
+void pio_output_toggle(pio_t pio)
+{
+    *portOf(pio) ^= 1 << (pio & 7);
+}
+
+
+
+bool pio_output_get(pio_t pio)
+/* Returns the level the pin is driven to. */
+{
+    return (*portOf(pio) >> (pio & 7)) & 1;
+}
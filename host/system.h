@@ -0,0 +1,24 @@
+/** FILE: host/system.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for the UCFK system.h, so that tone.c can
+ * be built into the host tools (see port.c) and the whole game into 
+ * the native build (see native.h).
+ */
+
+
+#ifndef SYSTEM_H
+#define SYSTEM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* The UCFK board, as in its target.h */
+#define LEDMAT_ROWS_NUM 7
+#define LEDMAT_COLS_NUM 5
+
+
+
+void system_init(void);
+
+#endif /* SYSTEM_H */
@@ -0,0 +1,33 @@
+/** FILE: host/task.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for the UCFK task.h, for the native build
+ * of the game (see native.h). The scheduler runs on simulated time.
+ */
+
+
+#ifndef TASK_H
+#define TASK_H
+
+#include "system.h"
+#include "timer.h"
+
+#define TASK_RATE TIMER_RATE
+
+typedef timer_tick_t task_tick_t;
+
+typedef struct task_struct
+{
+    void (*func)(void* data);
+    void* data;
+    task_tick_t period;
+    task_tick_t reschedule;
+} task_t;
+
+
+
+void task_schedule(task_t* tasks, uint8_t num_tasks);
+/* Runs each task every period ticks, for good. Simulated time jumps
+ * ahead to the next task that is due. */
+
+#endif /* TASK_H */
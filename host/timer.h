@@ -0,0 +1,22 @@
+/** FILE: host/timer.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for the UCFK timer.h. TIMER_RATE is given
+ * on the command line (see HOST_TIMER_RATE in the Makefile). Only the
+ * native build (see native.h) has a timer to read.
+ */
+
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "system.h"
+
+typedef uint16_t timer_tick_t;
+
+
+
+timer_tick_t timer_get(void);
+/* Returns the simulated timer 1 count. */
+
+#endif /* TIMER_H */
@@ -0,0 +1,43 @@
+/** FILE: host/tinygl.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for the UCFK tinygl.h, for the native 
+ * build of the game (see native.h). Text is not drawn: each text shown
+ * is recorded as one change to what the matrix shows.
+ */
+
+
+#ifndef TINYGL_H
+#define TINYGL_H
+
+#include "system.h"
+#include "font.h"
+
+typedef enum {TINYGL_TEXT_MODE_STEP, TINYGL_TEXT_MODE_SCROLL} tinygl_text_mode_t;
+
+
+
+void tinygl_init(uint16_t update_rate);
+
+
+
+void tinygl_font_set(font_t* font);
+
+
+
+void tinygl_text_speed_set(uint8_t speed);
+
+
+
+void tinygl_text_mode_set(tinygl_text_mode_t mode);
+
+
+
+void tinygl_text(const char* string);
+/* Records string as what the matrix shows. */
+
+
+
+void tinygl_update(void);
+
+#endif /* TINYGL_H */
@@ -0,0 +1,16 @@
+/** FILE: host/util/atomic.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host stand-in for util/atomic.h. The host tools run
+ * interrupts between statements of their own, so a block is simply run
+ * once.
+ */
+
+
+#ifndef UTIL_ATOMIC_H
+#define UTIL_ATOMIC_H
+
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_BLOCK(TYPE) for (int atomicOnce = 1; atomicOnce; atomicOnce = 0)
+
+#endif /* UTIL_ATOMIC_H */
@@ -0,0 +1,157 @@
+/** FILE: idle.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Puts the CPU to sleep (idle mode) between scheduler 
+ * ticks instead of letting the scheduler spin. See idle.h.
+ */
+
+#include "idle.h"
+#include "timer.h"
+#include "profile.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+static task_t* idleTasks = 0;
+static uint8_t idleNumTasks = 0;
+
+/* Timer ticks spent in, and asleep in, each phase */
+static uint32_t phaseTicks[IDLE_MAX_PHASES] = {0};
+static uint32_t sleepTicks[IDLE_MAX_PHASES] = {0};
+static uint8_t accountPhase = 0;
+static timer_tick_t lastTime = 0;
+
+static volatile bool isByteReceived = false;
+
+
+
+ISR(TIMER1_COMPA_vect)
+/* Wakes the CPU when the next task is nearly due. Only fires once. */
+{
+    TIMSK1 &= ~(1 << OCIE1A);
+}
+
+
+
+ISR(USART1_RX_vect)
+/* Wakes the CPU when an IR byte arrives. Only fires once, and leaves 
+ * the byte for ir_uart_getc. */
+{
+    UCSR1B &= ~(1 << RXCIE1);
+    isByteReceived = true;
+}
+
+
+
+void idleInit(task_t* tasks, uint8_t numTasks)
+/* Gives the idle module the scheduler's task table, so that it knows 
+ * when the next task is due. */
+{
+    idleTasks = tasks;
+    idleNumTasks = numTasks;
+    lastTime = timer_get();
+}
+
+
+
+void idleAccount(uint8_t phase)
+/* Counts the time since the last call as time spent in phase. Call 
+ * once per tick of the game loop. */
+{
+    timer_tick_t now = timer_get();
+
+    if (accountPhase < IDLE_MAX_PHASES) {
+        phaseTicks[accountPhase] += (timer_tick_t) (now - lastTime);
+    }
+    lastTime = now;
+    accountPhase = phase;
+}
+
+
+
+static timer_tick_t nextDue(uint8_t running, timer_tick_t now)
+/* Returns when the next task is due. The running task may or may not
+ * have been rescheduled yet, depending on the scheduler, so if its 
+ * time has passed its next time is used. */
+{
+    task_t* task = &idleTasks[running];
+    timer_tick_t due = task->reschedule;
+    uint8_t i = 0;
+
+    if ((int16_t) (due - now) <= 0) {
+        due += task->period;
+    }
+    for (i = 0; i < idleNumTasks; i++) {
+        if (i != running && (int16_t) (idleTasks[i].reschedule - due) < 0) {
+            due = idleTasks[i].reschedule;
+        }
+    }
+    return due;
+}
+
+
+
+bool idleSleep(uint8_t running)
+/* Sleeps until just before the next task is due. running is the index
+ * of the task that is calling this. Returns true if it was woken early
+ * because an IR byte arrived. */
+{
+    timer_tick_t now = timer_get();
+    timer_tick_t wake = nextDue(running, now) - IDLE_MARGIN_TICKS;
+
+    /* Nothing to gain, or a task is already late */
+    if ((int16_t) (wake - now) <= 0) {
+        return false;
+    }
+
+    PROFILE_BEGIN(PROFILE_SLEEP);
+    isByteReceived = false;
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    cli();
+    OCR1A = wake;
+    TIFR1 = (1 << OCF1A);
+    TIMSK1 |= (1 << OCIE1A);
+    UCSR1B |= (1 << RXCIE1);
+    sleep_enable();
+    /* Other interrupts (e.g the tone) also wake the CPU, so sleep again
+     * until one of ours has fired. sei() always lets the next 
+     * instruction run first, so an interrupt can't be missed between 
+     * the check and sleep_cpu(). */
+    while ((TIMSK1 & (1 << OCIE1A)) && (UCSR1B & (1 << RXCIE1))) {
+        sei();
+        sleep_cpu();
+        cli();
+    }
+    sleep_disable();
+    TIMSK1 &= ~(1 << OCIE1A);
+    UCSR1B &= ~(1 << RXCIE1);
+    sei();
+    PROFILE_END();
+
+    if (accountPhase < IDLE_MAX_PHASES) {
+        sleepTicks[accountPhase] += (timer_tick_t) (timer_get() - now);
+    }
+    return isByteReceived;
+}
+
+
+
+uint8_t idleSleepPercent(uint8_t phase)
+/* Returns the percentage of the time spent in phase that the CPU was 
+ * asleep. */
+{
+    uint32_t percent = 0;
+
+    if (phase >= IDLE_MAX_PHASES || phaseTicks[phase] == 0) {
+        return 0;
+    }
+    if (sleepTicks[phase] <= UINT32_MAX / 100) {
+        percent = sleepTicks[phase] * 100 / phaseTicks[phase];
+    } else {
+        /* sleepTicks * 100 would overflow (after about 23 minutes of 
+         * sleep), so divide phaseTicks first instead. It is so big by
+         * then that the + 1 (which avoids dividing by 0) makes no odds. */
+        percent = sleepTicks[phase] / (phaseTicks[phase] / 100 + 1);
+    }
+    return (uint8_t) (percent > 100 ? 100 : percent);
+}
@@ -0,0 +1,51 @@
+/** FILE: idle.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Puts the CPU to sleep (idle mode) between scheduler 
+ * ticks instead of letting the scheduler spin. The CPU is woken by the
+ * timer 1 compare A interrupt just before the next task is due, or 
+ * early by the IR receiver. Time spent asleep is counted per phase so
+ * that the saving can be measured.
+ */
+
+
+#ifndef IDLE_H
+#define IDLE_H
+
+#include "system.h"
+#include "task.h"
+#include <stdbool.h>
+
+/* Sleep time is counted for phases 0 to IDLE_MAX_PHASES-1 */
+#define IDLE_MAX_PHASES 5
+
+/* Wake up this many timer ticks before the next task is due, to allow 
+ * for the time taken to wake up and return to the scheduler. */
+#define IDLE_MARGIN_TICKS 4
+
+
+
+void idleInit(task_t* tasks, uint8_t numTasks);
+/* Gives the idle module the scheduler's task table, so that it knows 
+ * when the next task is due. */
+
+
+
+void idleAccount(uint8_t phase);
+/* Counts the time since the last call as time spent in phase. Call 
+ * once per tick of the game loop. */
+
+
+
+bool idleSleep(uint8_t running);
+/* Sleeps until just before the next task is due. running is the index
+ * of the task that is calling this. Returns true if it was woken early
+ * because an IR byte arrived. */
+
+
+
+uint8_t idleSleepPercent(uint8_t phase);
+/* Returns the percentage of the time spent in phase that the CPU was 
+ * asleep. */
+
+#endif /* IDLE_H */
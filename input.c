@@ -0,0 +1,136 @@
+/** FILE: input.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Samples the navswitch and button in a task of its own
+ * and queues up what happened as input events, so that the game only
+ * has to do work when the player actually does something.
+ */
+
+#include "input.h"
+#include "navswitch.h"
+#include "button.h"
+#include "profile.h"
+#include "trace.h"
+#include "script.h"
+
+#define INPUT_QUEUE_MASK (INPUT_QUEUE_SIZE - 1)
+
+static uint8_t queue[INPUT_QUEUE_SIZE];
+static uint8_t queueHead = 0; /* Next event to be read */
+static uint8_t queueTail = 0; /* Where the next event will be written */
+static bool isButtonDown = false;
+
+
+
+static void inputEventPut(uint8_t event)
+/* Adds an event to the queue, unless the queue is full. */
+{
+    if (((queueTail + 1) & INPUT_QUEUE_MASK) != queueHead) {
+        queue[queueTail] = event;
+        queueTail = (queueTail + 1) & INPUT_QUEUE_MASK;
+    }
+}
+
+
+
+void inputInit(void)
+/* Initialises the navswitch and button and empties the event queue. */
+{
+    navswitch_init();
+    button_init();
+    isButtonDown = false;
+    inputClear();
+}
+
+
+
+void inputSample(void)
+/* Samples the navswitch and button and queues any events. If the
+ * queue is full new events are dropped. */
+{
+#ifdef SCRIPT
+    /* Play the scripted game instead of reading the switches */
+    {
+        uint8_t event = scriptEvent();
+        if (event != INPUT_NONE) {
+            inputEventPut(event);
+        }
+        if (event == INPUT_BUTTON || event == INPUT_BUTTON_RELEASE) {
+            isButtonDown = event == INPUT_BUTTON;
+        }
+    }
+#else
+    navswitch_update();
+    button_update();
+
+    if (navswitch_push_event_p(NAVSWITCH_NORTH)) {
+        inputEventPut(INPUT_NORTH);
+    }
+    if (navswitch_push_event_p(NAVSWITCH_EAST)) {
+        inputEventPut(INPUT_EAST);
+    }
+    if (navswitch_push_event_p(NAVSWITCH_SOUTH)) {
+        inputEventPut(INPUT_SOUTH);
+    }
+    if (navswitch_push_event_p(NAVSWITCH_WEST)) {
+        inputEventPut(INPUT_WEST);
+    }
+    if (navswitch_push_event_p(NAVSWITCH_PUSH)) {
+        inputEventPut(INPUT_PUSH);
+    }
+    if (navswitch_release_event_p(NAVSWITCH_PUSH)) {
+        inputEventPut(INPUT_PUSH_RELEASE);
+    }
+    if (button_push_event_p(BUTTON1)) {
+        inputEventPut(INPUT_BUTTON);
+    }
+    if (button_release_event_p(BUTTON1)) {
+        inputEventPut(INPUT_BUTTON_RELEASE);
+    }
+    isButtonDown = button_down_p(BUTTON1);
+#endif
+}
+
+
+
+void inputTask(void* data)
+/* The input task: inputSample, profiled and traced. data is unused. */
+{
+    PROFILE_BEGIN(PROFILE_INPUT);
+    TRACE_EVENT(TRACE_BEGIN, PROFILE_INPUT);
+    (void) data;
+    inputSample();
+    TRACE_EVENT(TRACE_END, PROFILE_INPUT);
+    PROFILE_END();
+}
+
+
+
+uint8_t inputEventGet(void)
+/* Removes and returns the oldest queued event, or INPUT_NONE if there
+ * are no events. */
+{
+    uint8_t event = INPUT_NONE;
+
+    if (queueHead != queueTail) {
+        event = queue[queueHead];
+        queueHead = (queueHead + 1) & INPUT_QUEUE_MASK;
+    }
+    return event;
+}
+
+
+
+void inputClear(void)
+/* Throws away any queued events (e.g. ones made during another phase). */
+{
+    queueHead = queueTail;
+}
+
+
+
+bool inputButtonDown(void)
+/* Returns true if the button was down when it was last sampled. */
+{
+    return isButtonDown;
+}
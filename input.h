@@ -0,0 +1,68 @@
+/** FILE: input.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Samples the navswitch and button in a task of its own
+ * and queues up what happened as input events, so that the game only
+ * has to do work when the player actually does something.
+ */
+
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "system.h"
+#include <stdbool.h>
+
+/* Sampling at this rate also debounces the switches, since it is
+ * slower than the switches bounce. */
+#define INPUT_TASK_RATE 50
+
+/* Must be a power of 2 */
+#define INPUT_QUEUE_SIZE 8
+
+/* Input events. INPUT_NONE means the queue is empty. */
+#define INPUT_NONE 0
+#define INPUT_NORTH 1
+#define INPUT_EAST 2
+#define INPUT_SOUTH 3
+#define INPUT_WEST 4
+#define INPUT_PUSH 5
+#define INPUT_PUSH_RELEASE 6
+#define INPUT_BUTTON 7
+#define INPUT_BUTTON_RELEASE 8
+
+
+
+void inputInit(void);
+/* Initialises the navswitch and button and empties the event queue. */
+
+
+
+void inputSample(void);
+/* Samples the navswitch and button and queues any events. If the
+ * queue is full new events are dropped. Loops that wait with the
+ * scheduler blocked call this directly, so that they don't fill the
+ * trace with input task events. */
+
+
+
+void inputTask(void* data);
+/* The input task: inputSample, profiled and traced. data is unused. */
+
+
+
+uint8_t inputEventGet(void);
+/* Removes and returns the oldest queued event, or INPUT_NONE if there
+ * are no events. */
+
+
+
+void inputClear(void);
+/* Throws away any queued events (e.g. ones made during another phase). */
+
+
+
+bool inputButtonDown(void);
+/* Returns true if the button was down when it was last sampled. */
+
+#endif /* INPUT_H */
@@ -0,0 +1,27 @@
+/** FILE: link.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: The IR link to the other board. In scripted builds (see
+ * script.h) the other board is played by the script instead, or in the
+ * link build by another simulated board (see link_run.c).
+ */
+
+
+#ifndef LINK_H
+#define LINK_H
+
+#ifdef SCRIPT
+#include "script.h"
+#define LINK_INIT()
+#define LINK_READY() scriptIrReady()
+#define LINK_GETC() scriptIrGetc()
+#define LINK_PUTC(BYTE) scriptIrPutc(BYTE)
+#else
+#include "ir_uart.h"
+#define LINK_INIT() ir_uart_init()
+#define LINK_READY() ir_uart_read_ready_p()
+#define LINK_GETC() ir_uart_getc()
+#define LINK_PUTC(BYTE) ir_uart_putc(BYTE)
+#endif
+
+#endif /* LINK_H */
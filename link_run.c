@@ -0,0 +1,751 @@
+/** FILE: link_run.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host program that plays two simulated boards against
+ * each other ("make link"). Each board is the link build of the game
+ * (SIMLINK, see script.h) running in simavr in a process of its own,
+ * played by its own script (SCRIPT_LINK_PLAYER_1 and 2, or with -c the
+ * scenario given and the next, e.g SCRIPT_SALVO_PLAYER_1). The IR link
+ * between them is a pair of lock-free byte rings in shared memory, one
+ * for each direction, that can be slowed to the IR baud rate and made
+ * late, jittery, lossy and noisy.
+ *
+ * Built with NATIVE (link_run_native), each board is instead the native
+ * link build (see host/native.h) linked into link_run, and runs a match
+ * in a fraction of a second. Time on the native board moves a timer 
+ * tick (32 us) for each read of the timer, so a busy-wait polls a few 
+ * times less often than on the board and its poll counts are lower, but
+ * the time it spends waiting is the same.
+ *
+ * Sending never holds up the board, as ir_uart_putc does on the real
+ * board while the last byte is still going out, so bytes sent while
+ * the line is busy are counted instead. The receiver holds the three
+ * bytes the USART can (see RECEIVE_SIZE) and anything that arrives 
+ * while it is full is lost (an overrun).
+ *
+ * For each board it reports how long bytes sat in the receiver before
+ * the game read them (up to a period of communicationLoop when it is
+ * polling) and how long it spent spinning on the link with no byte to
+ * read. A spin in which the board sent something is the wait for a 
+ * reply in recordShot, and the average of those is the time from a 
+ * turn's shots being sent to the reply being read. Comparing it between
+ * builds with different SALVO_SHOTS (see -c) shows what a salvo saves.
+ *
+ * The boards keep within a quantum of simulated time of each other. As
+ * long as a byte takes at least that long to arrive (the byte time plus
+ * the latency), a run depends only on its options and seed.
+ *
+ * A lost or garbled byte can leave the boards waiting on each other for
+ * good, so a board gives up (stalled) after -t simulated seconds in all
+ * or -i simulated seconds without sending or reading a byte. If neither
+ * board's simulated time moves for -w seconds of real time, both are
+ * killed (hung), and a board whose simulator dies is reported as such
+ * instead of leaving the other waiting for it.
+ *
+ * Usage: link_run [-b baud] [-l latency] [-j jitter] [-p loss]
+ *                 [-f flips] [-q quantum] [-t seconds] [-i seconds]
+ *                 [-w seconds] [-s seed] [-c scenario] game_link.out
+ *        link_run_native [the same options]
+ * Times are in microseconds unless they are in seconds, loss and flips
+ * are the chance of each byte being lost or having a bit flipped, and
+ * a baud rate of 0 sends bytes instantly. -i 0 and -w 0 turn those
+ * checks off.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "script.h"
+
+#ifdef NATIVE
+#include "native.h"
+#else
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_io.h"
+#include "avr_eeprom.h"
+#endif
+
+#define NUM_BOARDS 2
+#define DEFAULT_MCU "atmega32u2"
+#define DEFAULT_FREQUENCY 8000000
+
+/* The native build counts time in timer ticks (see host/native.h), and
+ * is linked in, so there is no program to load */
+#ifdef NATIVE
+#define CYCLES_PER_TICK (DEFAULT_FREQUENCY / TIMER_RATE)
+#define NUM_PROGRAMS 0
+#define USAGE_PROGRAM ""
+#else
+#define NUM_PROGRAMS 1
+#define USAGE_PROGRAM " game_link.out"
+#endif
+
+/* The IR link of the UCFK runs at 2400 baud, 10 bits to a byte */
+#define DEFAULT_BAUD 2400
+#define BITS_PER_BYTE 10
+#define DEFAULT_QUANTUM_US 1000
+#define DEFAULT_SECONDS 120
+#define DEFAULT_IDLE_SECONDS 10
+#define DEFAULT_WALL_SECONDS 30
+
+/* How often the parent checks on the boards */
+#define WATCH_US 100000
+
+/* Bytes in flight in each direction, must be a power of 2 */
+#define RING_SIZE 256
+#define RING_MASK (RING_SIZE - 1)
+
+/* Bytes the USART can hold before the game reads them: its two byte 
+ * FIFO, and the shift register, which keeps a third until the next
+ * start bit comes in */
+#define RECEIVE_SIZE 3
+
+/* Polls for a byte closer together than this are a busy-wait, if 
+ * there are at least SPIN_MIN_POLLS of them (fewer are just tasks that
+ * poll the link running one after the other) */
+#define SPIN_GAP_US 100
+#define SPIN_MIN_POLLS 10
+
+#define US_PER_SECOND 1000000.0
+#define MS_PER_SECOND 1000.0
+
+
+
+/* How the link behaves, from the command line */
+typedef struct channel_s
+{
+    unsigned long baud;         /* 0 to send bytes instantly */
+    unsigned long latencyUs;
+    unsigned long jitterUs;     /* Up to this much is added to the latency */
+    double loss;                /* Chance of a byte being lost */
+    double flips;               /* Chance of a byte having a bit flipped */
+    unsigned long quantumUs;
+    unsigned long seconds;      /* Simulated time before a board gives up */
+    unsigned long idleSeconds;  /* Simulated time with no bytes before it gives up */
+    unsigned long wallSeconds;  /* Real time with no progress before both are killed */
+    unsigned long seed;
+    unsigned long scenario;     /* Played by player 1, and the next by player 2 */
+
+} Channel;
+
+
+
+typedef struct ring_entry_s
+{
+    uint64_t arrival;           /* Cycle the byte has fully arrived by */
+    uint8_t byte;
+
+} RingEntry;
+
+
+
+/* Bytes sent by one board and not yet taken by the other. Only the
+ * sender moves the tail and only the receiver moves the head. */
+typedef struct ring_s
+{
+    RingEntry entries[RING_SIZE];
+    atomic_uint head;
+    atomic_uint tail;
+
+} Ring;
+
+
+
+/* What one board did, written by its own process */
+typedef struct stats_s
+{
+    unsigned long numSent;
+    unsigned long numSentBusy;  /* Sent before the last byte had gone */
+    unsigned long numLost;
+    unsigned long numFlipped;
+    unsigned long numReceived;
+    unsigned long numOverrun;
+    uint64_t readDelay;         /* Cycles from arriving to being read */
+    uint64_t maxReadDelay;
+    unsigned long numPolls;
+    uint64_t spin;              /* Cycles spent busy-waiting */
+    uint64_t maxSpin;
+    unsigned long maxSpinPolls;
+    unsigned long numSpins;
+    uint64_t replyWait;         /* Cycles spent in spins that sent a byte */
+    uint64_t maxReplyWait;
+    unsigned long numReplyWaits;
+    uint64_t lastByte;          /* Cycle a byte was last sent or read */
+
+} Stats;
+
+
+
+enum {RUN_RUNNING, RUN_FINISHED, RUN_CRASHED, RUN_STALLED, RUN_FAILED, RUN_DIED, RUN_HUNG};
+
+
+
+/* Everything the two processes share */
+typedef struct board_s
+{
+    Ring ring;                  /* What this board has sent */
+    _Atomic uint64_t cycle;     /* How far this board has got */
+    uint64_t frequency;
+    atomic_int state;
+    Stats stats;
+
+} Board;
+
+
+
+/* What only the process running a board needs */
+typedef struct link_s
+{
+    const Channel* channel;
+    Board* board;
+    Board* other;
+    uint64_t frequency;
+    uint64_t quantum;           /* How far ahead of the other board it may get */
+    uint64_t limit;             /* Cycles before it gives up */
+    uint64_t idleLimit;         /* Cycles without a byte before it gives up */
+    uint64_t byteCycles;
+    uint64_t lineFree;          /* Cycle the line is free to send again */
+    uint64_t lastArrival;
+    uint64_t random;
+    uint8_t received[RECEIVE_SIZE];
+    uint64_t arrivals[RECEIVE_SIZE];
+    uint8_t numReceived;
+    uint64_t lastPoll;
+    uint64_t spinStart;
+    unsigned long spinPolls;
+    uint64_t lastSend;
+
+} Link;
+
+
+
+static uint64_t randomNext(Link* link)
+/* Returns the next number of a xorshift64 generator. */
+{
+    link->random ^= link->random << 13;
+    link->random ^= link->random >> 7;
+    link->random ^= link->random << 17;
+    return link->random;
+}
+
+
+
+static double randomChance(Link* link)
+/* Returns a number from 0 up to but not including 1. */
+{
+    return (randomNext(link) >> 11) * (1.0 / (UINT64_C(1) << 53));
+}
+
+
+
+static uint64_t usToCycles(const Link* link, unsigned long us)
+{
+    return (uint64_t) us * link->frequency / (uint64_t) US_PER_SECOND;
+}
+
+
+
+static double cyclesToMs(uint64_t frequency, uint64_t cycles)
+{
+    return cycles * MS_PER_SECOND / frequency;
+}
+
+
+
+static void linkArrive(Link* link, uint64_t now)
+/* Moves the bytes that have arrived by now from the other board into
+ * the receive buffer, losing any that find it full. */
+{
+    Ring* ring = &link->other->ring;
+    Stats* stats = &link->board->stats;
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    const RingEntry* entry = 0;
+
+    while (head != atomic_load_explicit(&ring->tail, memory_order_acquire)) {
+        entry = &ring->entries[head & RING_MASK];
+        if (entry->arrival > now) {
+            break;
+        }
+        if (link->numReceived < RECEIVE_SIZE) {
+            link->received[link->numReceived] = entry->byte;
+            link->arrivals[link->numReceived] = entry->arrival;
+            link->numReceived++;
+        } else {
+            stats->numOverrun++;
+        }
+        head++;
+        atomic_store_explicit(&ring->head, head, memory_order_release);
+    }
+}
+
+
+
+static void linkSpinEnd(Link* link, uint64_t now)
+/* Records the busy-wait that ends now, if there was one. */
+{
+    Stats* stats = &link->board->stats;
+    uint64_t spin = now - link->spinStart;
+
+    if (link->spinPolls >= SPIN_MIN_POLLS) {
+        stats->numSpins++;
+        stats->spin += spin;
+        if (spin > stats->maxSpin) {
+            stats->maxSpin = spin;
+            stats->maxSpinPolls = link->spinPolls;
+        }
+        if (link->lastSend >= link->spinStart) {
+            stats->numReplyWaits++;
+            stats->replyWait += spin;
+            if (spin > stats->maxReplyWait) {
+                stats->maxReplyWait = spin;
+            }
+        }
+    }
+    link->spinPolls = 0;
+}
+
+
+
+static bool linkPoll(Link* link, uint64_t now)
+/* The game polls the link: returns true if there is a byte. */
+{
+    linkArrive(link, now);
+    link->board->stats.numPolls++;
+    if (link->numReceived > 0) {
+        linkSpinEnd(link, now);
+    } else if (link->spinPolls > 0 && now - link->lastPoll < usToCycles(link, SPIN_GAP_US)) {
+        link->spinPolls++;
+    } else {
+        linkSpinEnd(link, now);
+        link->spinStart = now;
+        link->spinPolls = 1;
+    }
+    link->lastPoll = now;
+    return link->numReceived > 0;
+}
+
+
+
+static uint8_t linkRead(Link* link, uint64_t now)
+/* The game reads the link: returns the oldest byte received, or 0 if 
+ * there isn't one. */
+{
+    Stats* stats = &link->board->stats;
+    uint64_t delay = 0;
+    uint8_t byte = 0;
+    uint8_t i = 0;
+
+    linkArrive(link, now);
+    if (link->numReceived == 0) {
+        return 0;
+    }
+    byte = link->received[0];
+    delay = now - link->arrivals[0];
+    link->numReceived--;
+    for (i = 0; i < link->numReceived; i++) {
+        link->received[i] = link->received[i + 1];
+        link->arrivals[i] = link->arrivals[i + 1];
+    }
+
+    stats->numReceived++;
+    stats->lastByte = now;
+    stats->readDelay += delay;
+    if (delay > stats->maxReadDelay) {
+        stats->maxReadDelay = delay;
+    }
+    return byte;
+}
+
+
+
+static void linkSend(Link* link, uint64_t now, uint8_t byte)
+/* The game sends byte to the other board. */
+{
+    const Channel* channel = link->channel;
+    Stats* stats = &link->board->stats;
+    Ring* ring = &link->board->ring;
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint64_t arrival = 0;
+
+    stats->numSent++;
+    stats->lastByte = now;
+    link->lastSend = now;
+    if (now < link->lineFree) {
+        stats->numSentBusy++;
+    } else {
+        link->lineFree = now;
+    }
+    link->lineFree += link->byteCycles;
+
+    /* IR bytes can't overtake each other, however late one is */
+    arrival = link->lineFree + usToCycles(link, channel->latencyUs);
+    if (channel->jitterUs > 0) {
+        arrival += randomNext(link) % (usToCycles(link, channel->jitterUs) + 1);
+    }
+    if (arrival < link->lastArrival) {
+        arrival = link->lastArrival;
+    }
+    link->lastArrival = arrival;
+
+    if (randomChance(link) < channel->loss) {
+        stats->numLost++;
+        return;
+    }
+    if (randomChance(link) < channel->flips) {
+        byte ^= 1 << (randomNext(link) % 8);
+        stats->numFlipped++;
+    }
+    if (tail - atomic_load_explicit(&ring->head, memory_order_acquire) == RING_SIZE) {
+        stats->numLost++;
+        return;
+    }
+    ring->entries[tail & RING_MASK].arrival = arrival;
+    ring->entries[tail & RING_MASK].byte = byte;
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+
+
+static void linkStart(Link* link, const Channel* channel, Board boards[], int player, uint64_t frequency)
+/* Sets up the link of the board of player (0 or 1). */
+{
+    link->channel = channel;
+    link->board = &boards[player];
+    link->other = &boards[1 - player];
+    link->frequency = frequency;
+    link->board->frequency = frequency;
+    link->byteCycles = channel->baud == 0 ? 0 : frequency * BITS_PER_BYTE / channel->baud;
+    link->random = (channel->seed * 2 + player + 1) * UINT64_C(0x9e3779b97f4a7c15);
+    link->quantum = usToCycles(link, channel->quantumUs);
+    link->limit = (uint64_t) channel->seconds * frequency;
+    link->idleLimit = (uint64_t) channel->idleSeconds * frequency;
+}
+
+
+
+static bool linkTime(Link* link, uint64_t now)
+/* Tells the other board how far this one has got, and waits for it to
+ * catch up if it is more than a quantum behind. Returns false if this 
+ * board has run too long, or too long without using the link. */
+{
+    atomic_store_explicit(&link->board->cycle, now, memory_order_release);
+    if (now > link->limit || (link->idleLimit > 0 && now - link->board->stats.lastByte > link->idleLimit)) {
+        /* Count the busy-wait it is stuck in, if it is */
+        linkSpinEnd(link, link->lastPoll);
+        return false;
+    }
+    while (now > atomic_load_explicit(&link->other->cycle, memory_order_acquire) + link->quantum
+           && atomic_load(&link->other->state) == RUN_RUNNING) {
+        sched_yield();
+    }
+    return true;
+}
+
+
+
+#ifdef NATIVE
+/* The link of the board this process runs */
+static Link boardLink;
+
+
+
+void nativeTime(void)
+/* Keeps the boards together, and gives up on one that has run too 
+ * long. */
+{
+    if (!linkTime(&boardLink, (uint64_t) nativeTicks * CYCLES_PER_TICK)) {
+        atomic_store(&boardLink.board->state, RUN_STALLED);
+        _exit(EXIT_SUCCESS);
+    }
+}
+
+
+
+void nativeStopped(void)
+/* The board's script has ended. */
+{
+    atomic_store(&boardLink.board->state, RUN_FINISHED);
+    _exit(EXIT_SUCCESS);
+}
+
+
+
+bool nativeLinkReady(void)
+{
+    return linkPoll(&boardLink, (uint64_t) nativeTicks * CYCLES_PER_TICK);
+}
+
+
+
+uint8_t nativeLinkGetc(void)
+{
+    return linkRead(&boardLink, (uint64_t) nativeTicks * CYCLES_PER_TICK);
+}
+
+
+
+void nativeLinkPutc(uint8_t byte)
+{
+    linkSend(&boardLink, (uint64_t) nativeTicks * CYCLES_PER_TICK, byte);
+}
+
+
+
+static int boardRun(const char* program, const Channel* channel, Board boards[], int player)
+/* Runs the native build as the board of player (0 or 1). It ends the
+ * process (see nativeStopped and nativeTime) instead of returning. */
+{
+    (void) program;
+    nativeReset();
+    nativeEeprom[SCRIPT_SCENARIO_ADDRESS] = (uint8_t) (channel->scenario + player);
+    nativeEeprom[SCRIPT_SCENARIO_ADDRESS + 1] = 0;
+    linkStart(&boardLink, channel, boards, player, DEFAULT_FREQUENCY);
+    gameMain();
+    return RUN_CRASHED;
+}
+#else
+
+
+
+static uint8_t linkStatusRead(struct avr_t* avr, avr_io_addr_t addr, void* param)
+/* The game polls SCRIPT_LINK_STATUS: returns 1 if there is a byte. */
+{
+    (void) addr;
+    return linkPoll(param, avr->cycle);
+}
+
+
+
+static uint8_t linkDataRead(struct avr_t* avr, avr_io_addr_t addr, void* param)
+/* The game reads SCRIPT_LINK_DATA: returns the oldest byte received,
+ * or 0 if there isn't one. */
+{
+    (void) addr;
+    return linkRead(param, avr->cycle);
+}
+
+
+
+static void linkDataWrite(struct avr_t* avr, avr_io_addr_t addr, uint8_t byte, void* param)
+/* The game writes SCRIPT_LINK_DATA: sends byte to the other board. */
+{
+    (void) addr;
+    linkSend(param, avr->cycle, byte);
+}
+
+
+
+static int boardRun(const char* program, const Channel* channel, Board boards[], int player)
+/* Runs the board of player (0 or 1) until its script ends, or until it
+ * has run too long or too long without using the link. Returns how the
+ * run ended. */
+{
+    static Link link;
+    elf_firmware_t firmware;
+    avr_eeprom_desc_t eeprom;
+    uint8_t scenario[2] = {(uint8_t) (channel->scenario + player), 0};
+    avr_t* avr = 0;
+    int state = cpu_Running;
+
+    memset(&firmware, 0, sizeof(firmware));
+    if (elf_read_firmware(program, &firmware) != 0) {
+        return RUN_FAILED;
+    }
+    if (firmware.mmcu[0] == '\0') {
+        snprintf(firmware.mmcu, sizeof(firmware.mmcu), "%s", DEFAULT_MCU);
+    }
+    if (firmware.frequency == 0) {
+        firmware.frequency = DEFAULT_FREQUENCY;
+    }
+    avr = avr_make_mcu_by_name(firmware.mmcu);
+    if (avr == 0) {
+        return RUN_FAILED;
+    }
+    avr_init(avr);
+    avr_load_firmware(avr, &firmware);
+
+    eeprom.ee = scenario;
+    eeprom.offset = SCRIPT_SCENARIO_ADDRESS;
+    eeprom.size = sizeof(scenario);
+    avr_ioctl(avr, AVR_IOCTL_EEPROM_SET, &eeprom);
+
+    linkStart(&link, channel, boards, player, firmware.frequency);
+    avr_register_io_read(avr, SCRIPT_LINK_STATUS, linkStatusRead, &link);
+    avr_register_io_read(avr, SCRIPT_LINK_DATA, linkDataRead, &link);
+    avr_register_io_write(avr, SCRIPT_LINK_DATA, linkDataWrite, &link);
+
+    while (state != cpu_Done && state != cpu_Crashed) {
+        state = avr_run(avr);
+        if (!linkTime(&link, avr->cycle)) {
+            return RUN_STALLED;
+        }
+    }
+    return state == cpu_Done ? RUN_FINISHED : RUN_CRASHED;
+}
+#endif /* NATIVE */
+
+
+
+static void boardReport(const Board* board, int player)
+/* Prints what the board of player did. */
+{
+    static const char* endings[] = {"still running", "finished", "crashed", "stalled", "could not be started",
+                                    "died (the simulator was killed)", "hung (simulated time stopped)"};
+    const Stats* stats = &board->stats;
+    uint64_t frequency = board->frequency == 0 ? DEFAULT_FREQUENCY : board->frequency;
+    double meanDelay = stats->numReceived == 0 ? 0 : (double) stats->readDelay / stats->numReceived;
+
+    printf("player %d: %s after %.3f s\n", player + 1, endings[atomic_load(&board->state)],
+           cyclesToMs(frequency, atomic_load(&board->cycle)) / MS_PER_SECOND);
+    printf("  sent %lu bytes (%lu while the line was busy), %lu lost, %lu flipped\n",
+           stats->numSent, stats->numSentBusy, stats->numLost, stats->numFlipped);
+    printf("  received %lu bytes (%lu overrun), read %.2f ms after arriving on average, %.2f ms at most\n",
+           stats->numReceived, stats->numOverrun, meanDelay * MS_PER_SECOND / frequency,
+           cyclesToMs(frequency, stats->maxReadDelay));
+    printf("  polled %lu times, busy-waiting for %.2f ms in %lu waits (%.2f ms on average, longest %.2f ms, %lu polls)\n",
+           stats->numPolls, cyclesToMs(frequency, stats->spin), stats->numSpins,
+           stats->numSpins == 0 ? 0 : cyclesToMs(frequency, stats->spin) / stats->numSpins,
+           cyclesToMs(frequency, stats->maxSpin), stats->maxSpinPolls);
+    printf("  waited for %lu replies, %.2f ms on average, %.2f ms at most\n", stats->numReplyWaits,
+           stats->numReplyWaits == 0 ? 0 : cyclesToMs(frequency, stats->replyWait) / stats->numReplyWaits,
+           cyclesToMs(frequency, stats->maxReplyWait));
+    if (atomic_load(&board->state) != RUN_FINISHED) {
+        printf("  last byte sent or read at %.3f s\n", cyclesToMs(frequency, stats->lastByte) / MS_PER_SECOND);
+    }
+}
+
+
+
+static void boardsWatch(const Channel* channel, Board boards[], const pid_t pids[])
+/* Waits for both boards to end. A board whose process dies is marked
+ * as dead, so that the other stops waiting for it, and if neither
+ * board gets any further for channel->wallSeconds both are killed. */
+{
+    uint64_t cycles[NUM_BOARDS] = {0};
+    bool isRunning[NUM_BOARDS] = {true, true};
+    time_t lastProgress = time(0);
+    int numRunning = NUM_BOARDS;
+    int player = 0;
+    int status = 0;
+
+    while (numRunning > 0) {
+        for (player = 0; player < NUM_BOARDS; player++) {
+            if (!isRunning[player] || waitpid(pids[player], &status, WNOHANG) != pids[player]) {
+                continue;
+            }
+            isRunning[player] = false;
+            numRunning--;
+            if (!WIFEXITED(status) && atomic_load(&boards[player].state) == RUN_RUNNING) {
+                atomic_store(&boards[player].state, RUN_DIED);
+            }
+        }
+        for (player = 0; player < NUM_BOARDS; player++) {
+            if (isRunning[player] && atomic_load(&boards[player].cycle) != cycles[player]) {
+                cycles[player] = atomic_load(&boards[player].cycle);
+                lastProgress = time(0);
+            }
+        }
+        if (channel->wallSeconds > 0 && time(0) - lastProgress > (time_t) channel->wallSeconds) {
+            for (player = 0; player < NUM_BOARDS; player++) {
+                if (isRunning[player]) {
+                    kill(pids[player], SIGKILL);
+                    waitpid(pids[player], &status, 0);
+                    atomic_store(&boards[player].state, RUN_HUNG);
+                }
+            }
+            return;
+        }
+        usleep(WATCH_US);
+    }
+}
+
+
+
+int main(int argc, char* argv[])
+{
+    Channel channel = {DEFAULT_BAUD, 0, 0, 0, 0, DEFAULT_QUANTUM_US, DEFAULT_SECONDS,
+                       DEFAULT_IDLE_SECONDS, DEFAULT_WALL_SECONDS, 1, SCRIPT_LINK_PLAYER_1};
+    Board* boards = 0;
+    pid_t pids[NUM_BOARDS];
+    int player = 0;
+    int option = 0;
+    int state = 0;
+
+    while ((option = getopt(argc, argv, "b:l:j:p:f:q:t:i:w:s:c:")) != -1) {
+        if (option == 'b') {
+            channel.baud = strtoul(optarg, 0, 10);
+        } else if (option == 'l') {
+            channel.latencyUs = strtoul(optarg, 0, 10);
+        } else if (option == 'j') {
+            channel.jitterUs = strtoul(optarg, 0, 10);
+        } else if (option == 'p') {
+            channel.loss = strtod(optarg, 0);
+        } else if (option == 'f') {
+            channel.flips = strtod(optarg, 0);
+        } else if (option == 'q') {
+            channel.quantumUs = strtoul(optarg, 0, 10);
+        } else if (option == 't') {
+            channel.seconds = strtoul(optarg, 0, 10);
+        } else if (option == 'i') {
+            channel.idleSeconds = strtoul(optarg, 0, 10);
+        } else if (option == 'w') {
+            channel.wallSeconds = strtoul(optarg, 0, 10);
+        } else if (option == 's') {
+            channel.seed = strtoul(optarg, 0, 10);
+        } else if (option == 'c') {
+            channel.scenario = strtoul(optarg, 0, 10);
+        }
+    }
+    if (optind != argc - NUM_PROGRAMS) {
+        fprintf(stderr, "usage: %s [-b baud] [-l latency] [-j jitter] [-p loss] [-f flips] "
+                "[-q quantum] [-t seconds] [-i seconds] [-w seconds] [-s seed] [-c scenario]" USAGE_PROGRAM "\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    boards = mmap(0, NUM_BOARDS * sizeof(Board), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (boards == MAP_FAILED) {
+        perror("mmap");
+        return EXIT_FAILURE;
+    }
+    for (player = 0; player < NUM_BOARDS; player++) {
+        atomic_init(&boards[player].ring.head, 0);
+        atomic_init(&boards[player].ring.tail, 0);
+        atomic_init(&boards[player].cycle, 0);
+        atomic_init(&boards[player].state, RUN_RUNNING);
+    }
+
+    for (player = 0; player < NUM_BOARDS; player++) {
+        pids[player] = fork();
+        if (pids[player] < 0) {
+            perror("fork");
+            return EXIT_FAILURE;
+        }
+        if (pids[player] == 0) {
+            atomic_store(&boards[player].state, boardRun(argv[optind], &channel, boards, player));
+            _exit(EXIT_SUCCESS);
+        }
+    }
+    boardsWatch(&channel, boards, pids);
+
+    printf("link: %lu baud, latency %lu us, jitter %lu us, loss %g, flips %g, seed %lu, scenarios %lu and %lu\n",
+           channel.baud, channel.latencyUs, channel.jitterUs, channel.loss, channel.flips, channel.seed,
+           channel.scenario, channel.scenario + 1);
+    state = EXIT_SUCCESS;
+    for (player = 0; player < NUM_BOARDS; player++) {
+        boardReport(&boards[player], player);
+        if (atomic_load(&boards[player].state) != RUN_FINISHED) {
+            state = EXIT_FAILURE;
+        }
+    }
+    return state;
+}
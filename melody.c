@@ -0,0 +1,116 @@
+/** FILE: melody.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Plays tunes stored in flash as compact note bytecode.
+ * See melody.h for the bytecode format.
+ */
+
+#include "melody.h"
+#include "flash.h"
+
+/* Number of ticks at the end of each note where the note is silenced,
+ * so that repeated notes can be heard as separate notes. */
+#define MELODY_GAP_TICKS 1
+
+
+
+static void melodyStart(Melody* melody, const uint8_t* tune)
+/* Loads the tempo of tune and positions the player at its first note. */
+{
+    uint16_t bpm = (uint16_t) pgm_read_byte(tune) * MELODY_TEMPO_STEP;
+
+    melody->tune = tune;
+    melody->next = tune + 1;
+    melody->ticksPerBeat = (uint16_t) (((uint32_t) melody->pollRate * 60) / bpm);
+    melody->ticksLeft = 0;
+}
+
+
+
+static void melodyStop(Melody* melody)
+/* Silences the current note and stops playing. */
+{
+    melody->callback(melody->callbackData, melody->note, 0);
+    melody->tune = 0;
+}
+
+
+
+void melodyInit(Melody* melody, uint16_t pollRate, melodyCallback_t callback, void* callbackData)
+/* Initialises a melody player that will be updated pollRate times a
+ * second and will play notes through callback. */
+{
+    melody->tune = 0;
+    melody->next = 0;
+    melody->background = 0;
+    melody->pollRate = pollRate;
+    melody->ticksPerBeat = 0;
+    melody->ticksLeft = 0;
+    melody->note = 0;
+    melody->callback = callback;
+    melody->callbackData = callbackData;
+}
+
+
+
+void melodyBackgroundSet(Melody* melody, const uint8_t* tune)
+/* Starts playing tune (in flash) and makes it the tune that is
+ * returned to after any tune started with melodyPlay has finished. */
+{
+    melody->background = tune;
+    melodyStart(melody, tune);
+}
+
+
+
+void melodyPlay(Melody* melody, const uint8_t* tune)
+/* Starts playing tune (in flash) immediately. When it ends, the
+ * background tune (if any) starts again from the beginning. */
+{
+    melodyStart(melody, tune);
+}
+
+
+
+void melodyUpdate(Melody* melody)
+/* Advances the player by one tick. Must be called pollRate times a second. */
+{
+    uint8_t code = 0;
+    uint8_t note = 0;
+
+    if (melody->tune == 0) {
+        return;
+    }
+
+    if (melody->ticksLeft > 0) {
+        melody->ticksLeft--;
+        if (melody->ticksLeft == MELODY_GAP_TICKS) {
+            melody->callback(melody->callbackData, melody->note, 0);
+        }
+        return;
+    }
+
+    code = pgm_read_byte(melody->next);
+    if (code == MELODY_LOOP) {
+        melody->next = melody->tune + 1;
+        code = pgm_read_byte(melody->next);
+    } else if (code == MELODY_END) {
+        if (melody->background != 0 && melody->background != melody->tune) {
+            melodyStart(melody, melody->background);
+            code = pgm_read_byte(melody->next);
+        } else {
+            melodyStop(melody);
+            return;
+        }
+    }
+    melody->next++;
+
+    note = code & MELODY_NOTE_MASK;
+    melody->ticksLeft = ((code >> MELODY_BEATS_SHIFT) + 1) * melody->ticksPerBeat - 1;
+    if (note == MELODY_REST_NOTE) {
+        melody->callback(melody->callbackData, melody->note, 0);
+    } else {
+        melody->note = MELODY_BASE_NOTE + note;
+        melody->callback(melody->callbackData, melody->note, MELODY_VELOCITY);
+    }
+}
@@ -0,0 +1,116 @@
+/** FILE: melody.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Plays tunes stored in flash as compact note bytecode.
+ * Tunes are compiled by the preprocessor from the MELODY_* macros
+ * below, so nothing is parsed at run time and no tune is copied into
+ * SRAM.
+ *
+ * A tune is a byte array in program memory. The first byte is the
+ * tempo in steps of MELODY_TEMPO_STEP beats per minute (so that fast
+ * jingles fit in a byte) and each following byte is one note: the
+ * low 6 bits are the note (semitones above C of MELODY_BASE_OCTAVE) and
+ * the high 2 bits are its length in beats minus one. The tune finishes
+ * with MELODY_END (play once) or MELODY_LOOP (start again).
+ */
+
+
+#ifndef MELODY_H
+#define MELODY_H
+
+#include <stdint.h>
+#include "flash.h"
+
+/* Note names, as semitones above C */
+#define NOTE_C 0
+#define NOTE_CS 1
+#define NOTE_D 2
+#define NOTE_DS 3
+#define NOTE_E 4
+#define NOTE_F 5
+#define NOTE_FS 6
+#define NOTE_G 7
+#define NOTE_GS 8
+#define NOTE_A 9
+#define NOTE_AS 10
+#define NOTE_B 11
+
+/* The lowest octave a tune can use. Notes are passed to the player
+ * callback as MIDI note numbers (C4 = 60). */
+#define MELODY_BASE_OCTAVE 2
+#define MELODY_BASE_NOTE ((MELODY_BASE_OCTAVE + 1) * 12)
+
+#define MELODY_NOTE_MASK 0x3f
+#define MELODY_BEATS_SHIFT 6
+#define MELODY_MAX_BEATS 4
+
+/* Reserved note values. Everything below MELODY_REST_NOTE is a pitch. */
+#define MELODY_REST_NOTE 0x3e
+#define MELODY_CONTROL_NOTE 0x3f
+
+#define MELODY_VELOCITY 100
+
+/* Tempos are stored divided by this, up to MELODY_MAX_BPM */
+#define MELODY_TEMPO_STEP 2
+#define MELODY_MAX_BPM (UINT8_MAX * MELODY_TEMPO_STEP)
+
+/* Bytecode "compiler" macros for writing tunes */
+/* MELODY_TEMPO fails to compile (negative array size) if BPM is too
+ * fast to store or not a whole number of steps */
+#define MELODY_TEMPO(BPM) \
+    ((uint8_t) ((BPM) / MELODY_TEMPO_STEP \
+        + 0 * sizeof(char[(BPM) > 0 && (BPM) <= MELODY_MAX_BPM && (BPM) % MELODY_TEMPO_STEP == 0 ? 1 : -1])))
+#define MELODY_NOTE(NAME, OCTAVE, BEATS) \
+    ((uint8_t) ((((BEATS) - 1) << MELODY_BEATS_SHIFT) | (((OCTAVE) - MELODY_BASE_OCTAVE) * 12 + (NAME))))
+#define MELODY_REST(BEATS) \
+    ((uint8_t) ((((BEATS) - 1) << MELODY_BEATS_SHIFT) | MELODY_REST_NOTE))
+#define MELODY_END ((uint8_t) (MELODY_CONTROL_NOTE))
+#define MELODY_LOOP ((uint8_t) ((1 << MELODY_BEATS_SHIFT) | MELODY_CONTROL_NOTE))
+
+
+
+/* Called with a MIDI note number whenever a note starts, and with a
+ * velocity of 0 when the note should stop sounding. */
+typedef void (*melodyCallback_t)(void* data, uint8_t note, uint8_t velocity);
+
+
+
+/* The state of a melody player */
+typedef struct melody_s
+{
+    const uint8_t* tune;        /* Start of the tune being played (in flash), 0 if silent */
+    const uint8_t* next;        /* Next note byte to be played (in flash) */
+    const uint8_t* background;  /* Tune to return to once a one-off tune finishes */
+    uint16_t pollRate;
+    uint16_t ticksPerBeat;
+    uint16_t ticksLeft;
+    uint8_t note;
+    melodyCallback_t callback;
+    void* callbackData;
+
+} Melody;
+
+
+
+void melodyInit(Melody* melody, uint16_t pollRate, melodyCallback_t callback, void* callbackData);
+/* Initialises a melody player that will be updated pollRate times a
+ * second and will play notes through callback. */
+
+
+
+void melodyBackgroundSet(Melody* melody, const uint8_t* tune);
+/* Starts playing tune (in flash) and makes it the tune that is
+ * returned to after any tune started with melodyPlay has finished. */
+
+
+
+void melodyPlay(Melody* melody, const uint8_t* tune);
+/* Starts playing tune (in flash) immediately. When it ends, the
+ * background tune (if any) starts again from the beginning. */
+
+
+
+void melodyUpdate(Melody* melody);
+/* Advances the player by one tick. Must be called pollRate times a second. */
+
+#endif /* MELODY_H */
@@ -0,0 +1,125 @@
+/** FILE: mem_usage.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Measures how much of the 1 KB of SRAM is in use. The 
+ * free space between the static variables and the stack is painted 
+ * with a known byte at boot, so the deepest the stack has ever reached
+ * can be found by looking for where the paint has been overwritten.
+ */
+
+#include "mem_usage.h"
+#include <avr/io.h>
+
+#define PAINT 0xc5
+
+/* Provided by the linker: the end of the static variables */
+extern uint8_t _end;
+
+static uint16_t phasePeaks[MEM_USAGE_MAX_PHASES] = {0};
+
+/* The phase being measured, the stack used since the last repaint is its */
+static uint8_t currentPhase = MEM_USAGE_NO_PHASE;
+
+/* The deepest the stack reached before the last repaint */
+static uint16_t repaintedPeak = 0;
+
+
+
+void memUsagePaint(void) __attribute__ ((naked, used, section (".init3")));
+void memUsagePaint(void)
+/* Paints the free space at boot, after the stack pointer has been set 
+ * up but before main is called. */
+{
+    uint8_t* address = &_end;
+
+    while (address < (uint8_t*) SP) {
+        *address = PAINT;
+        address++;
+    }
+}
+
+
+
+uint16_t memUsageStatic(void)
+/* Returns the number of bytes used by static variables (.data and .bss). */
+{
+    return (uint16_t) (&_end - (uint8_t*) RAMSTART);
+}
+
+
+
+uint16_t memUsageStackFree(void)
+/* Returns the number of bytes between the static variables and the 
+ * deepest the stack has reached, i.e the smallest the gap between them
+ * has ever been. */
+{
+    const uint8_t* address = &_end;
+
+    while (address <= (uint8_t*) RAMEND && *address == PAINT) {
+        address++;
+    }
+    return (uint16_t) (address - &_end);
+}
+
+
+
+static uint16_t stackPeakSinceRepaint(void)
+/* Returns the most bytes of stack used since the free space was last painted. */
+{
+    return (uint16_t) ((uint8_t*) RAMEND + 1 - &_end) - memUsageStackFree();
+}
+
+
+
+uint16_t memUsageStackPeak(void)
+/* Returns the most bytes of stack that have ever been used. */
+{
+    uint16_t peak = stackPeakSinceRepaint();
+
+    return peak > repaintedPeak ? peak : repaintedPeak;
+}
+
+
+
+void memUsagePhaseStart(uint8_t phase)
+/* Records the stack peak reached during the phase the game is leaving,
+ * if any, then repaints the free space so that phase is measured on its
+ * own. Call when the game moves into phase. */
+{
+    uint16_t peak = stackPeakSinceRepaint();
+    uint8_t* address = &_end;
+
+    if (currentPhase < MEM_USAGE_MAX_PHASES && peak > phasePeaks[currentPhase]) {
+        phasePeaks[currentPhase] = peak;
+    }
+    currentPhase = phase;
+    if (peak > repaintedPeak) {
+        repaintedPeak = peak;
+    }
+
+    /* Everything below the stack pointer is free. An interrupt may use 
+     * some of it while we paint, but will be finished with it when it returns. */
+    while (address < (uint8_t*) SP) {
+        *address = PAINT;
+        address++;
+    }
+}
+
+
+
+uint16_t memUsagePhasePeak(uint8_t phase)
+/* Returns the most bytes of stack used during phase so far, including
+ * the time since it was last entered if the game is in it now, or 0 if
+ * it has not been entered. */
+{
+    uint16_t peak = 0;
+
+    if (phase >= MEM_USAGE_MAX_PHASES) {
+        return 0;
+    }
+    peak = phasePeaks[phase];
+    if (phase == currentPhase && stackPeakSinceRepaint() > peak) {
+        peak = stackPeakSinceRepaint();
+    }
+    return peak;
+}
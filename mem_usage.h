@@ -0,0 +1,53 @@
+/** FILE: mem_usage.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Measures how much of the 1 KB of SRAM is in use. The 
+ * free space between the static variables and the stack is painted 
+ * with a known byte at boot, so the deepest the stack has ever reached
+ * can be found by looking for where the paint has been overwritten.
+ */
+
+
+#ifndef MEM_USAGE_H
+#define MEM_USAGE_H
+
+#include "system.h"
+
+/* Stack peaks are kept for phases 0 to MEM_USAGE_MAX_PHASES-1 */
+#define MEM_USAGE_MAX_PHASES 5
+
+/* The phase before memUsagePhaseStart is first called */
+#define MEM_USAGE_NO_PHASE 0xff
+
+
+
+uint16_t memUsageStatic(void);
+/* Returns the number of bytes used by static variables (.data and .bss). */
+
+
+
+uint16_t memUsageStackFree(void);
+/* Returns the number of bytes between the static variables and the 
+ * deepest the stack has reached, i.e the smallest the gap between them
+ * has ever been. */
+
+
+
+uint16_t memUsageStackPeak(void);
+/* Returns the most bytes of stack that have ever been used. */
+
+
+
+void memUsagePhaseStart(uint8_t phase);
+/* Records the stack peak reached during the phase the game is leaving,
+ * if any, then repaints the free space so that phase is measured on its
+ * own. Call when the game moves into phase. */
+
+
+
+uint16_t memUsagePhasePeak(uint8_t phase);
+/* Returns the most bytes of stack used during phase so far, including
+ * the time since it was last entered if the game is in it now, or 0 if
+ * it has not been entered. */
+
+#endif /* MEM_USAGE_H */
@@ -5,44 +5,39 @@
  */
 
 #include "music.h"
-#include "pio.h"
-#include "../../extra/tweeter.h"
-#include "../../extra/mmelody.h"
-
-#define PIEZO_PIO PIO_DEFINE (PORT_D, 6)
-
-#define TWEETER_TASK_RATE 10000
-#define TUNE_TASK_RATE 100
-#define TUNE_BPM_RATE 200
+#include "tone.h"
+#include "melody.h"
+#include "tunes.h"
+#include "profile.h"
+#include "trace.h"
 
 
 
 void musicInit(MusicObj* musicObj)
-/* Initialises the music routine.*/
+/* Initialises the music routine and starts the theme music (see tunes.h). */
 {
-    static tweeter_scale_t scale_table[] = TWEETER_SCALE_TABLE(TWEETER_TASK_RATE);
-    musicObj->tweeter = tweeter_init(&musicObj->tweeterInfo, TWEETER_TASK_RATE, scale_table);
-    pio_config_set(PIEZO_PIO, PIO_OUTPUT_LOW);
-
-    musicObj->melody = mmelody_init(&musicObj->melodyInfo, TUNE_TASK_RATE, (mmelody_callback_t) tweeter_note_play, musicObj->tweeter);
-    mmelody_speed_set (musicObj->melody, TUNE_BPM_RATE);
-    mmelody_play (musicObj->melody, theme);
+    toneInit();
+    melodyInit(&musicObj->melody, TUNE_TASK_RATE, toneNotePlay, 0);
+    melodyBackgroundSet(&musicObj->melody, themeTune);
 }
 
 
 
-void tuneTask (void* data)
-/* Changes the note for tweeterTask to play when required. */
+void musicPlay(MusicObj* musicObj, const uint8_t* tune)
+/* Plays a jingle (see tunes.h) once, then goes back to the theme music. */
 {
-    MusicObj* musicObj = data;
-    mmelody_update(musicObj->melody);
+    melodyPlay(&musicObj->melody, tune);
 }
 
 
 
-void tweeterTask (void* data)
-/* Plays the note set by tuneTask. */
+void tuneTask (void* data)
+/* Changes the note played by the piezo timer when required. */
 {
+    PROFILE_BEGIN(PROFILE_TUNE_TASK);
+    TRACE_EVENT(TRACE_BEGIN, PROFILE_TUNE_TASK);
     MusicObj* musicObj = data;
-    pio_output_set(PIEZO_PIO, tweeter_update(musicObj->tweeter));
+    melodyUpdate(&musicObj->melody);
+    TRACE_EVENT(TRACE_END, PROFILE_TUNE_TASK);
+    PROFILE_END();
 }
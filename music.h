@@ -8,46 +8,34 @@
 #ifndef MUSIC_H
 #define MUSIC_H
 
-#include "pio.h"
-#include "../../extra/tweeter.h"
-#include "../../extra/mmelody.h"
+#include "tone.h"
+#include "melody.h"
+#include "tunes.h"
 
-#define PIEZO_PIO PIO_DEFINE (PORT_D, 6)
-
-#define TWEETER_TASK_RATE 10000
 #define TUNE_TASK_RATE 100
-#define TUNE_BPM_RATE 200
-
-
-/* The theme music to be played. See mmelody.h for how to write your own
- * themes/music. */
-extern char* theme;
 
 
 
-/* A music structure containing tweeters and melody objects nessesary for sound.*/
+/* A music structure containing the melody object nessesary for sound.*/
 typedef struct musicObj_s
 {
-    tweeter_t tweeter;
-    mmelody_private_t* melody;
-    mmelody_obj_t melodyInfo;
-    tweeter_obj_t tweeterInfo;
+    Melody melody;
 
 } MusicObj;
 
 
 
 void musicInit(MusicObj* musicObj);
-/* Initialises the music routine.*/
+/* Initialises the music routine and starts the theme music (see tunes.h). */
 
 
 
-void tuneTask (void* data);
-/* Changes the note for tweeterTask to play when required. */
+void musicPlay(MusicObj* musicObj, const uint8_t* tune);
+/* Plays a jingle (see tunes.h) once, then goes back to the theme music. */
 
 
 
-void tweeterTask (void* data);
-/* Plays the note set by tuneTask. */
+void tuneTask (void* data);
+/* Changes the note played by the piezo timer when required. */
 
 #endif /* MUSIC_H */
@@ -0,0 +1,244 @@
+/** FILE: music_render.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host program that runs the melody player and the piezo
+ * tone generator (the game's own melody.c and tone.c, built against 
+ * the stand-ins in host/) under a virtual timer 1, and writes what the
+ * piezo pin would do to a WAV file. Build with "make render".
+ *
+ * It counts the tuneTask calls and tone interrupts per second of audio.
+ * Given the output of profile_report (-p, which "make render" passes 
+ * when "make profile" has left profile.txt behind) it also estimates 
+ * the CPU they take from the cycles they were measured to take under 
+ * simavr. tuneTask's average includes the note changes it made in the
+ * profiled game.
+ *
+ * Usage: music_render [-r sampleRate] [-s seconds] [-u tuneTaskRate]
+ *                     [-p profile.txt] [-t theme|hit|miss|sunk|win|lose] out.wav
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "melody.h"
+#include "tunes.h"
+#include "tone.h"
+
+#define DEFAULT_SAMPLE_RATE 44100
+#define DEFAULT_SECONDS 10
+#define DEFAULT_TUNE_TASK_RATE 100
+#define SAMPLE_AMPLITUDE 8000
+#define CPU_RATE 8000000UL
+#define MAX_LINE 256
+
+/* The names profile_report gives the work being costed (see profile.h) */
+#define TUNE_TASK_NAME "tuneTask"
+#define TONE_INTERRUPT_NAME "toneInterrupt"
+
+
+
+/* Measured cycles per call, 0 if not known */
+typedef struct costs_s
+{
+    double tuneTask;
+    double toneInterrupt;
+
+} Costs;
+
+
+
+static unsigned long noteChanges = 0;
+
+
+
+static void notePlay(void* data, uint8_t note, uint8_t velocity)
+/* Counts the note changes on their way to toneNotePlay. */
+{
+    noteChanges++;
+    toneNotePlay(data, note, velocity);
+}
+
+
+
+static bool costsRead(const char* fileName, Costs* costs)
+/* Reads the average cycles per call of tuneTask and the tone interrupt
+ * from the flat profile printed by profile_report. Returns false if the
+ * file can't be read or doesn't have both. */
+{
+    FILE* file = fopen(fileName, "r");
+    char line[MAX_LINE];
+    char name[MAX_LINE];
+    unsigned long calls = 0;
+    double selfCycles = 0;
+    double selfPercent = 0;
+    double totalCycles = 0;
+
+    if (file == 0) {
+        return false;
+    }
+    while (fgets(line, sizeof(line), file) != 0) {
+        if (sscanf(line, "%255s %lu %lf %lf%% %lf", name, &calls, &selfCycles, &selfPercent, &totalCycles) != 5
+            || calls == 0) {
+            continue;
+        }
+        if (strcmp(name, TUNE_TASK_NAME) == 0) {
+            costs->tuneTask = totalCycles / calls;
+        } else if (strcmp(name, TONE_INTERRUPT_NAME) == 0) {
+            costs->toneInterrupt = totalCycles / calls;
+        }
+    }
+    fclose(file);
+    return costs->tuneTask > 0 && costs->toneInterrupt > 0;
+}
+
+
+
+static void writeLittleEndian(FILE* file, uint32_t value, int numBytes)
+/* Writes the low numBytes bytes of value to file, least significant first. */
+{
+    int i = 0;
+    for (i = 0; i < numBytes; i++) {
+        fputc((value >> (8 * i)) & 0xff, file);
+    }
+}
+
+
+
+static void writeWavHeader(FILE* file, uint32_t sampleRate, uint32_t numSamples)
+/* Writes the header of a mono 16-bit PCM WAV file. */
+{
+    uint32_t dataBytes = numSamples * 2;
+
+    fwrite("RIFF", 1, 4, file);
+    writeLittleEndian(file, 36 + dataBytes, 4);
+    fwrite("WAVEfmt ", 1, 8, file);
+    writeLittleEndian(file, 16, 4);
+    writeLittleEndian(file, 1, 2);
+    writeLittleEndian(file, 1, 2);
+    writeLittleEndian(file, sampleRate, 4);
+    writeLittleEndian(file, sampleRate * 2, 4);
+    writeLittleEndian(file, 2, 2);
+    writeLittleEndian(file, 16, 2);
+    fwrite("data", 1, 4, file);
+    writeLittleEndian(file, dataBytes, 4);
+}
+
+
+
+static const uint8_t* findTune(const char* name)
+/* Returns the tune called name, or 0 if there is no such tune. */
+{
+    if (strcmp(name, "theme") == 0) {
+        return themeTune;
+    } else if (strcmp(name, "hit") == 0) {
+        return hitTune;
+    } else if (strcmp(name, "miss") == 0) {
+        return missTune;
+    } else if (strcmp(name, "sunk") == 0) {
+        return sunkTune;
+    } else if (strcmp(name, "win") == 0) {
+        return winTune;
+    } else if (strcmp(name, "lose") == 0) {
+        return loseTune;
+    }
+    return 0;
+}
+
+
+
+int main(int argc, char* argv[])
+{
+    uint32_t sampleRate = DEFAULT_SAMPLE_RATE;
+    uint32_t seconds = DEFAULT_SECONDS;
+    uint16_t tuneTaskRate = DEFAULT_TUNE_TASK_RATE;
+    const uint8_t* tune = themeTune;
+    const char* profileName = 0;
+    uint32_t numSamples = 0;
+    uint32_t sample = 0;
+    uint32_t tuneTaskPeriod = 0;
+    uint64_t now = 0;
+    unsigned long tuneTasks = 0;
+    unsigned long interrupts = 0;
+    double cyclesPerSecond = 0;
+    Costs costs = {0, 0};
+    Melody melody;
+    FILE* file = 0;
+    int option = 0;
+
+    while ((option = getopt(argc, argv, "r:s:u:p:t:")) != -1) {
+        if (option == 'r') {
+            sampleRate = strtoul(optarg, 0, 10);
+        } else if (option == 's') {
+            seconds = strtoul(optarg, 0, 10);
+        } else if (option == 'u') {
+            tuneTaskRate = strtoul(optarg, 0, 10);
+        } else if (option == 'p') {
+            profileName = optarg;
+        } else if (option == 't') {
+            tune = findTune(optarg);
+        } else {
+            tune = 0;
+        }
+    }
+    if (optind != argc - 1 || tune == 0 || sampleRate == 0 || seconds == 0 || tuneTaskRate == 0) {
+        fprintf(stderr, "usage: %s [-r sampleRate] [-s seconds] [-u tuneTaskRate] [-p profile.txt] "
+                "[-t theme|hit|miss|sunk|win|lose] out.wav\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (profileName != 0 && !costsRead(profileName, &costs)) {
+        fprintf(stderr, "%s: no %s and %s cycles, see make profile\n", profileName,
+                TUNE_TASK_NAME, TONE_INTERRUPT_NAME);
+        return EXIT_FAILURE;
+    }
+
+    file = fopen(argv[optind], "wb");
+    if (file == 0) {
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+    }
+
+    /* Same set up as musicInit */
+    toneInit();
+    melodyInit(&melody, tuneTaskRate, notePlay, 0);
+    melodyBackgroundSet(&melody, tune);
+    tuneTaskPeriod = TIMER_RATE / tuneTaskRate;
+
+    numSamples = sampleRate * seconds;
+    writeWavHeader(file, sampleRate, numSamples);
+    for (sample = 0; sample < numSamples; sample++) {
+        /* Run timer 1 up to the time of this sample, firing the compare
+         * interrupt when it matches. tone.c only writes TIFR1 to clear
+         * a stale match, which can't happen here, so it is ignored. */
+        while (now < (uint64_t) sample * TIMER_RATE / sampleRate) {
+            if (now % tuneTaskPeriod == 0) {
+                melodyUpdate(&melody);
+                tuneTasks++;
+            }
+            now++;
+            TCNT1 = (uint16_t) now;
+            if ((TIMSK1 & (1 << OCIE1B)) && TCNT1 == OCR1B) {
+                TIMER1_COMPB_vect();
+                interrupts++;
+            }
+        }
+        writeLittleEndian(file, (uint16_t) (pio_output_get(PIEZO_PIO) ? SAMPLE_AMPLITUDE : -SAMPLE_AMPLITUDE), 2);
+    }
+    fclose(file);
+
+    printf("tuneTask calls/s:     %.1f\n", (double) tuneTasks / seconds);
+    printf("note changes/s:       %.1f\n", (double) noteChanges / seconds);
+    printf("tone interrupts/s:    %.1f\n", (double) interrupts / seconds);
+    if (profileName == 0) {
+        printf("cycles/s:             unknown, give -p the output of profile_report\n");
+        return EXIT_SUCCESS;
+    }
+    cyclesPerSecond = ((double) tuneTasks * costs.tuneTask + (double) interrupts * costs.toneInterrupt) / seconds;
+    printf("cycles/s:             %.0f (%.2f%% of CPU, from %.1f cycles per tuneTask and %.1f per interrupt)\n",
+           cyclesPerSecond, 100.0 * cyclesPerSecond / CPU_RATE, costs.tuneTask, costs.toneInterrupt);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,71 @@
+/** FILE: phase.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: A table driven state machine for the phases of the 
+ * game. Each phase has a handler that is called every tick, and 
+ * optional entry and exit actions that are only called when the 
+ * machine moves between phases.
+ */
+
+#include "phase.h"
+#include "timer.h"
+#include "flash.h"
+#include <string.h>
+
+
+
+static void phaseActionRun(const phaseHandler_t* action, void* data)
+/* Calls the action stored at action (in flash), if there is one. */
+{
+    phaseHandler_t handler = (phaseHandler_t) pgm_read_ptr(action);
+
+    if (handler != 0) {
+        handler(data);
+    }
+}
+
+
+
+void phaseMachineInit(PhaseMachine* machine, const Phase table[])
+/* Initialises a phase machine with a table (in flash) of phases. The 
+ * machine starts in PHASE_NONE. */
+{
+    machine->table = table;
+    machine->current = PHASE_NONE;
+    machine->previous = PHASE_NONE;
+    memset(machine->entries, 0, sizeof(machine->entries));
+    memset(machine->maxTransitionTicks, 0, sizeof(machine->maxTransitionTicks));
+}
+
+
+
+void phaseMachineUpdate(PhaseMachine* machine, uint8_t phase, void* data)
+/* Moves the machine to phase if it is not already there, running the 
+ * exit action of the old phase and the entry action of the new one, 
+ * then runs the handler of phase. data is passed to every action. 
+ * Transitions into phase are counted and the longest is kept. */
+{
+    timer_tick_t start = 0;
+    timer_tick_t ticks = 0;
+
+    if (phase != machine->current) {
+        start = timer_get();
+        if (machine->current != PHASE_NONE) {
+            phaseActionRun(&machine->table[machine->current].exit, data);
+        }
+        machine->previous = machine->current;
+        machine->current = phase;
+        phaseActionRun(&machine->table[phase].entry, data);
+
+        ticks = timer_get() - start;
+        if (phase < PHASE_MAX_PHASES) {
+            if (machine->entries[phase] < UINT16_MAX) {
+                machine->entries[phase]++;
+            }
+            if (ticks > machine->maxTransitionTicks[phase]) {
+                machine->maxTransitionTicks[phase] = ticks;
+            }
+        }
+    }
+    phaseActionRun(&machine->table[phase].run, data);
+}
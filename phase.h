@@ -0,0 +1,67 @@
+/** FILE: phase.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: A table driven state machine for the phases of the 
+ * game. Each phase has a handler that is called every tick, and 
+ * optional entry and exit actions that are only called when the 
+ * machine moves between phases.
+ */
+
+
+#ifndef PHASE_H
+#define PHASE_H
+
+#include "system.h"
+#include "timer.h"
+
+/* The current phase before the first transition has happened */
+#define PHASE_NONE 0xff
+
+/* Transitions are counted and timed for phases 0 to PHASE_MAX_PHASES-1 */
+#define PHASE_MAX_PHASES 5
+
+
+
+typedef void (*phaseHandler_t)(void* data);
+
+
+
+/* One entry of a phase table. entry and exit may be 0. */
+typedef struct phase_s
+{
+    phaseHandler_t entry;
+    phaseHandler_t run;
+    phaseHandler_t exit;
+
+} Phase;
+
+
+
+/* The state of a phase machine, plus statistics about the transitions
+ * into each phase. A transition's time is the exit action of the old
+ * phase plus the entry action of the new one. */
+typedef struct phaseMachine_s
+{
+    const Phase* table;          /* In flash */
+    uint8_t current;
+    uint8_t previous;
+    uint16_t entries[PHASE_MAX_PHASES];
+    timer_tick_t maxTransitionTicks[PHASE_MAX_PHASES];
+
+} PhaseMachine;
+
+
+
+void phaseMachineInit(PhaseMachine* machine, const Phase table[]);
+/* Initialises a phase machine with a table (in flash) of phases. The 
+ * machine starts in PHASE_NONE. */
+
+
+
+void phaseMachineUpdate(PhaseMachine* machine, uint8_t phase, void* data);
+/* Moves the machine to phase if it is not already there, running the 
+ * exit action of the old phase and the entry action of the new one, 
+ * then runs the handler of phase. data is passed to every action. 
+ * Transitions into phase are counted and the longest is kept. */
+
+#endif /* PHASE_H */
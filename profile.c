@@ -0,0 +1,31 @@
+/** FILE: profile.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Support for profiling the game under the simavr 
+ * simulator (see profile.h): tells simavr what to trace. The game that
+ * is profiled is played by scenario 0 of script.c. Only built into the
+ * profiling build.
+ */
+
+#include "profile.h"
+
+#ifdef PROFILE
+
+#include "system.h"
+#include <avr/io.h>
+#include "avr_mcu_section.h"
+
+/* VCD timestamps are in simulated time, so the period only sets how 
+ * often simavr flushes the file. */
+#define PROFILE_VCD_PERIOD 1000
+
+AVR_MCU(F_CPU, "atmega32u2");
+AVR_MCU_VCD_FILE("game_profile.vcd", PROFILE_VCD_PERIOD);
+
+const struct avr_mmcu_vcd_trace_t profileTrace[] _MMCU_ =
+{
+    { AVR_MCU_VCD_SYMBOL("PROFILE"), .what = (void*) &GPIOR0, },
+    { AVR_MCU_VCD_SYMBOL("PIEZO"), .mask = (1 << 6), .what = (void*) &PORTD, },
+};
+
+#endif /* PROFILE */
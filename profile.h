@@ -0,0 +1,56 @@
+/** FILE: profile.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Instrumentation for profiling the game under the simavr
+ * simulator ("make profile"). Code being profiled is wrapped in
+ * PROFILE_BEGIN/PROFILE_END or PROFILE_CALL, which write an id into the GPIOR0
+ * register. simavr records every change of GPIOR0 with its cycle time
+ * into a VCD file, which profile_report turns into cycles per function.
+ * When PROFILE is not defined the macros compile to nothing.
+ */
+
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+
+/* Ids of the profiled code. 0 means the scheduler is idle. */
+#define PROFILE_IDLE 0
+#define PROFILE_PHASE(PHASE) (1 + (PHASE))
+#define PROFILE_TUNE_TASK 6
+#define PROFILE_COMMUNICATION 7
+#define PROFILE_INPUT 8
+#define PROFILE_TONE_ISR 9
+#define PROFILE_TINYGL 10
+#define PROFILE_SHIP_COLUMN 11
+#define PROFILE_SLEEP 12
+#define PROFILE_NUM_IDS 13
+
+/* Names of the ids, in order, for profile_report */
+#define PROFILE_NAMES \
+{ \
+    "idle", "placementLoop", "fireLoop", "waitingLoop", "endLoop", \
+    "resyncLoop", "tuneTask", "communicationLoop", "inputTask", "toneInterrupt", \
+    "tinygl_update", "shipColumn", "sleep" \
+}
+
+#if defined(PROFILE) && defined(__AVR__)
+#include <avr/io.h>
+
+/* The previous id is restored at the end, so profiled code can nest 
+ * (e.g an interrupt during a task). */
+#define PROFILE_BEGIN(ID) uint8_t profileSaved = GPIOR0; GPIOR0 = (ID)
+#define PROFILE_END() GPIOR0 = profileSaved
+
+/* Profiles a single statement, e.g a call to a library function */
+#define PROFILE_CALL(ID, STATEMENT) \
+    do { uint8_t profileCallSaved = GPIOR0; GPIOR0 = (ID); STATEMENT; GPIOR0 = profileCallSaved; } while (0)
+
+#else
+#define PROFILE_BEGIN(ID)
+#define PROFILE_END()
+#define PROFILE_CALL(ID, STATEMENT) STATEMENT
+#endif
+
+#endif /* PROFILE_H */
@@ -0,0 +1,281 @@
+/** FILE: profile_report.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host program that reads the VCD file written by simavr
+ * during "make profile" (see profile.h) and prints a flat profile and
+ * a call graph, in cycles, of the profiled code, plus the worst number
+ * of cycles the scheduler was busy for in one tick.
+ *
+ * The tasks that are due in the same tick run one after the other,
+ * with only the scheduler's own code (which is not profiled) between
+ * them, so runs less than a gap apart (-g, in cycles) are counted as
+ * one tick. Sleeping ends a tick.
+ *
+ * Usage: profile_report [-f cpuHz] [-g gapCycles] game_profile.vcd
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "profile.h"
+
+#define DEFAULT_CPU_RATE 8000000.0
+/* Well under a timer tick (256 cycles), well over the scheduler's loop */
+#define DEFAULT_TICK_GAP 128.0
+#define MAX_DEPTH 8
+#define MAX_LINE 256
+#define TRACE_NAME "PROFILE"
+
+
+
+/* Cycle counts for one profile id */
+typedef struct profileEntry_s
+{
+    unsigned long calls;
+    double selfCycles;
+    double totalCycles;     /* Including nested ids */
+    double maxCycles;       /* Longest single call, including nested ids */
+
+} ProfileEntry;
+
+
+
+/* The state of the replay of the trace */
+typedef struct profile_s
+{
+    ProfileEntry entries[PROFILE_NUM_IDS];
+    double edgeCycles[PROFILE_NUM_IDS][PROFILE_NUM_IDS];
+    unsigned long edgeCalls[PROFILE_NUM_IDS][PROFILE_NUM_IDS];
+    uint8_t stack[MAX_DEPTH];
+    double startCycles[MAX_DEPTH];
+    int depth;
+    double lastCycles;
+    double tickGap;
+    bool isTickOpen;        /* Some task has run since the last sleep or gap */
+    double tickEnd;         /* When the last task of the tick returned */
+    double tickCycles;      /* Cycles spent in the tick's tasks */
+    double maxTickCycles;
+    unsigned long ticks;
+
+} Profile;
+
+
+
+static void profileTickEnd(Profile* profile)
+/* Records the busy time of the tick that is open, if there is one. */
+{
+    if (profile->isTickOpen) {
+        profile->ticks++;
+        if (profile->tickCycles > profile->maxTickCycles) {
+            profile->maxTickCycles = profile->tickCycles;
+        }
+        profile->isTickOpen = false;
+    }
+}
+
+
+
+static void profileEnter(Profile* profile, uint8_t id, double cycles)
+/* Records that id has started, nested inside the id on top of the stack. */
+{
+    if (profile->depth == MAX_DEPTH || id >= PROFILE_NUM_IDS) {
+        return;
+    }
+    if (profile->depth == 1) {
+        /* A task (or interrupt) starting out of idle: part of the open
+         * tick unless it is a while since the last one finished */
+        if (profile->isTickOpen && (id == PROFILE_SLEEP || cycles - profile->tickEnd > profile->tickGap)) {
+            profileTickEnd(profile);
+        }
+        if (id != PROFILE_SLEEP && !profile->isTickOpen) {
+            profile->isTickOpen = true;
+            profile->tickCycles = 0;
+        }
+    }
+    profile->stack[profile->depth] = id;
+    profile->startCycles[profile->depth] = cycles;
+    profile->depth++;
+}
+
+
+
+static void profileLeave(Profile* profile, double cycles)
+/* Records that the id on top of the stack has finished. */
+{
+    uint8_t id = profile->stack[profile->depth - 1];
+    uint8_t parent = profile->stack[profile->depth - 2];
+    double callCycles = cycles - profile->startCycles[profile->depth - 1];
+    ProfileEntry* entry = &profile->entries[id];
+
+    entry->calls++;
+    entry->totalCycles += callCycles;
+    if (callCycles > entry->maxCycles) {
+        entry->maxCycles = callCycles;
+    }
+    profile->edgeCycles[parent][id] += callCycles;
+    profile->edgeCalls[parent][id]++;
+    profile->depth--;
+
+    if (profile->depth == 1 && id != PROFILE_SLEEP) {
+        profile->tickEnd = cycles;
+        profile->tickCycles += callCycles;
+    }
+}
+
+
+
+static void profileChange(Profile* profile, uint8_t id, double cycles)
+/* Handles the PROFILE register changing to id. Profiled code restores
+ * the previous id when it finishes, so going back to the id below the
+ * top of the stack is a return and anything else is a new call. */
+{
+    profile->entries[profile->stack[profile->depth - 1]].selfCycles += cycles - profile->lastCycles;
+    profile->lastCycles = cycles;
+
+    if (profile->depth >= 2 && id == profile->stack[profile->depth - 2]) {
+        profileLeave(profile, cycles);
+    } else if (id == PROFILE_IDLE) {
+        /* Lost track (e.g the trace started mid call), start again */
+        while (profile->depth > 1) {
+            profileLeave(profile, cycles);
+        }
+    } else {
+        profileEnter(profile, id, cycles);
+    }
+}
+
+
+
+static double timescaleSeconds(const char* text)
+/* Converts a VCD timescale such as "1ns" or "100 ps" into seconds. */
+{
+    char* unit = 0;
+    double number = strtod(text, &unit);
+
+    while (*unit == ' ') {
+        unit++;
+    }
+    if (strncmp(unit, "ps", 2) == 0) {
+        return number * 1e-12;
+    } else if (strncmp(unit, "ns", 2) == 0) {
+        return number * 1e-9;
+    } else if (strncmp(unit, "us", 2) == 0) {
+        return number * 1e-6;
+    } else if (strncmp(unit, "ms", 2) == 0) {
+        return number * 1e-3;
+    }
+    return number;
+}
+
+
+
+static void profilePrint(const Profile* profile, double totalCycles)
+/* Prints the flat profile, the call graph and the worst tick. */
+{
+    static const char* names[PROFILE_NUM_IDS] = PROFILE_NAMES;
+    int id = 0;
+    int child = 0;
+
+    printf("Flat profile (%.0f cycles traced)\n", totalCycles);
+    printf("%-20s %10s %14s %7s %14s %12s\n", "id", "calls", "self cycles", "self%", "total cycles", "max/call");
+    for (id = 0; id < PROFILE_NUM_IDS; id++) {
+        const ProfileEntry* entry = &profile->entries[id];
+        if (entry->calls == 0 && entry->selfCycles == 0) {
+            continue;
+        }
+        printf("%-20s %10lu %14.0f %6.2f%% %14.0f %12.0f\n", names[id], entry->calls,
+               entry->selfCycles, totalCycles > 0 ? 100.0 * entry->selfCycles / totalCycles : 0,
+               entry->totalCycles, entry->maxCycles);
+    }
+
+    printf("\nCall graph (caller -> callee: calls, cycles including nested calls)\n");
+    for (id = 0; id < PROFILE_NUM_IDS; id++) {
+        for (child = 0; child < PROFILE_NUM_IDS; child++) {
+            if (profile->edgeCalls[id][child] > 0) {
+                printf("%-20s -> %-20s %10lu %14.0f\n", names[id], names[child],
+                       profile->edgeCalls[id][child], profile->edgeCycles[id][child]);
+            }
+        }
+    }
+
+    printf("\nScheduler ticks: %lu, worst %.0f cycles of tasks in one tick (runs under %.0f cycles apart are one tick)\n",
+           profile->ticks, profile->maxTickCycles, profile->tickGap);
+}
+
+
+
+int main(int argc, char* argv[])
+{
+    static Profile profile;
+    double cpuRate = DEFAULT_CPU_RATE;
+    double secondsPerUnit = 1e-9;
+    double cycles = 0;
+    char line[MAX_LINE];
+    char code[MAX_LINE] = "";
+    char name[MAX_LINE];
+    char varCode[MAX_LINE];
+    FILE* file = 0;
+    int option = 0;
+    int width = 0;
+
+    profile.tickGap = DEFAULT_TICK_GAP;
+    while ((option = getopt(argc, argv, "f:g:")) != -1) {
+        if (option == 'f') {
+            cpuRate = strtod(optarg, 0);
+        } else if (option == 'g') {
+            profile.tickGap = strtod(optarg, 0);
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "usage: %s [-f cpuHz] [-g gapCycles] game_profile.vcd\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    file = fopen(argv[optind], "r");
+    if (file == 0) {
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+    }
+
+    profile.depth = 1;
+    profile.stack[0] = PROFILE_IDLE;
+
+    while (fgets(line, sizeof(line), file) != 0) {
+        if (strncmp(line, "$timescale", 10) == 0) {
+            if (strlen(line) <= 11 || strstr(line, "$end") == line + 11) {
+                /* The timescale is on the next line */
+                if (fgets(line, sizeof(line), file) == 0) {
+                    break;
+                }
+                secondsPerUnit = timescaleSeconds(line);
+            } else {
+                secondsPerUnit = timescaleSeconds(line + 10);
+            }
+        } else if (strncmp(line, "$var", 4) == 0) {
+            if (sscanf(line, "$var %*s %d %s %s", &width, varCode, name) == 3
+                && strcmp(name, TRACE_NAME) == 0) {
+                strcpy(code, varCode);
+            }
+        } else if (line[0] == '#') {
+            cycles = strtod(line + 1, 0) * secondsPerUnit * cpuRate;
+        } else if (line[0] == 'b' && code[0] != '\0') {
+            char* space = strchr(line, ' ');
+            if (space != 0 && strncmp(space + 1, code, strlen(code)) == 0
+                && (space[1 + strlen(code)] == '\n' || space[1 + strlen(code)] == '\0')) {
+                profileChange(&profile, (uint8_t) strtoul(line + 1, 0, 2), cycles);
+            }
+        }
+    }
+    fclose(file);
+
+    if (code[0] == '\0') {
+        fprintf(stderr, "%s: no %s trace found\n", argv[optind], TRACE_NAME);
+        return EXIT_FAILURE;
+    }
+    profile.entries[profile.stack[profile.depth - 1]].selfCycles += cycles - profile.lastCycles;
+    profileTickEnd(&profile);
+    profilePrint(&profile, cycles);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,553 @@
+/** FILE: script.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Scripted games for running the game under the simavr
+ * simulator. See script.h.
+ */
+
+#include "script.h"
+
+#ifdef SCRIPT
+
+#include "system.h"
+#include "input.h"
+#include "flash.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/eeprom.h>
+
+#ifdef NATIVE
+#include "native.h"
+#endif
+
+/* Bytes from the opponent not read yet (one less than this), must be a
+ * power of 2 */
+#define IR_QUEUE_SIZE 8
+#define IR_QUEUE_MASK (IR_QUEUE_SIZE - 1)
+
+/* What the opponent sends, as in game.c: a shot at (row, column), a
+ * reply, and REMATCH_BYTE. */
+#define SHOT(ROW, COLUMN) ((((ROW) + 1) << 4) | ((COLUMN) + 1))
+#define HIT 'H'
+#define MISS 'M'
+#define REMATCH 0x7f
+
+/* As in game.c, for the generated scenarios */
+#ifndef SALVO_SHOTS
+#define SALVO_SHOTS 1
+#endif
+#define SALVO_HEADER 0xf0
+#define SALVO_REPLY 0x80
+#define SUNK_REPLY 'X'
+#define FRAME_SIZE (SALVO_SHOTS > 1 ? SALVO_SHOTS + 1 : 1)
+#define NUM_SHIPS 2
+#define BOARD_ROWS 7
+#define BOARD_COLS 5
+
+/* A generated scenario is this many steps (not counting the releases
+ * that follow presses, or the shots of a salvo) that each wait up to
+ * GENERATED_MAX_WAIT input samples, then waits GENERATED_END_WAIT for
+ * the game to settle and ends. */
+#define GENERATED_STEPS 100
+#define GENERATED_MAX_WAIT 10
+#define GENERATED_END_WAIT 50
+/* Mixes up the generator after seeding, so that neighbouring scenario
+ * numbers play nothing alike */
+#define GENERATED_WARM_UP 8
+
+/* Steps for placing both ships where they start, with the second one
+ * moved down a row so that they don't overlap. The ships are then at
+ * (3, 1), (3, 2), (3, 3) and (4, 2). */
+#define PLACE_SHIPS \
+    25, INPUT_PUSH, 5, INPUT_PUSH_RELEASE, \
+    25, INPUT_SOUTH, 25, INPUT_PUSH, 5, INPUT_PUSH_RELEASE
+
+/* Steps for firing at the cursor and getting REPLY back */
+#define FIRE(REPLY) \
+    25, INPUT_PUSH, 5, SCRIPT_IR, (REPLY), 5, INPUT_PUSH_RELEASE
+
+/* Steps for firing at the cursor at another simulated board and 
+ * waiting for its reply */
+#define FIRE_LINKED \
+    25, INPUT_PUSH, 5, INPUT_PUSH_RELEASE, 1, SCRIPT_SYNC
+
+/* A step that waits for a byte from another simulated board if 
+ * CONDITION holds, and does nothing (for an input sample) otherwise */
+#define SYNC_IF(CONDITION) 0, ((CONDITION) ? SCRIPT_SYNC : INPUT_NONE)
+
+/* Steps for waiting for a frame of the other board's shots if 
+ * CONDITION holds (FRAME_SIZE is at most 6) */
+#define FRAME_SYNC_IF(CONDITION) \
+    SYNC_IF((CONDITION) && FRAME_SIZE > 0), SYNC_IF((CONDITION) && FRAME_SIZE > 1), \
+    SYNC_IF((CONDITION) && FRAME_SIZE > 2), SYNC_IF((CONDITION) && FRAME_SIZE > 3), \
+    SYNC_IF((CONDITION) && FRAME_SIZE > 4), SYNC_IF((CONDITION) && FRAME_SIZE > 5)
+
+/* Steps for moving the cursor (INPUT_NONE to stay) and marking a shot */
+#define MARK(MOVE) 25, (MOVE), 25, INPUT_PUSH, 5, INPUT_PUSH_RELEASE
+
+/* Steps after marking the SHOTS-th shot of a salvo match: if that ends
+ * a turn, waiting for the reply and then the other board's turn */
+#define TURN_END(SHOTS) \
+    SYNC_IF((SHOTS) % SALVO_SHOTS == 0), FRAME_SYNC_IF((SHOTS) % SALVO_SHOTS == 0)
+
+
+
+/* Selects player 1, places a vertical and a single ship, then moves
+ * the cursor, checks the misses and fires. The shot is never answered,
+ * so the script ends while recordShot waits. This is the game that is
+ * profiled. */
+static const uint8_t profileGame[] PROGMEM =
+{
+    10, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    25, INPUT_EAST, 25, INPUT_SOUTH, 25, INPUT_BUTTON, 5, INPUT_BUTTON_RELEASE,
+    25, INPUT_WEST, 25, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    25, INPUT_NORTH, 25, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    100, INPUT_EAST, 25, INPUT_SOUTH, 25, INPUT_BUTTON, 50, INPUT_BUTTON_RELEASE,
+    25, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    250, SCRIPT_END
+};
+
+
+
+/* Player 1 moves the first ship to the right edge, rotates it there
+ * and moves it up past the top so it wraps to the bottom. The second
+ * ship wraps past the left edge. Then one shot misses. */
+static const uint8_t edgePlacement[] PROGMEM =
+{
+    10, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    25, INPUT_EAST, 25, INPUT_EAST, 25, INPUT_BUTTON, 5, INPUT_BUTTON_RELEASE,
+    25, INPUT_NORTH, 25, INPUT_NORTH, 25, INPUT_NORTH, 25, INPUT_NORTH,
+    25, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    25, INPUT_WEST, 25, INPUT_WEST, 25, INPUT_WEST, 25, INPUT_SOUTH,
+    25, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    FIRE(MISS),
+    100, SCRIPT_END
+};
+
+
+
+/* Player 2 is shot at the same cell twice: the first shot hits and the
+ * second misses, since that part of the ship has already gone. */
+static const uint8_t sameCellTwice[] PROGMEM =
+{
+    10, INPUT_NORTH, 10, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    PLACE_SHIPS,
+    50, SCRIPT_IR, SHOT(3, 2),
+    50, INPUT_EAST, FIRE(MISS),
+    50, SCRIPT_IR, SHOT(3, 2),
+    50, INPUT_EAST, FIRE(MISS),
+    50, SCRIPT_IR, SHOT(4, 2),
+    100, SCRIPT_END
+};
+
+
+
+/* Player 1 hits four times and wins, looks at both reports on the end
+ * screen, then both players ask for a rematch. */
+static const uint8_t winAndRematch[] PROGMEM =
+{
+    10, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    PLACE_SHIPS,
+    FIRE(HIT), 50, SCRIPT_IR, SHOT(0, 0),
+    25, INPUT_EAST, FIRE(HIT), 50, SCRIPT_IR, SHOT(0, 1),
+    25, INPUT_EAST, FIRE(HIT), 50, SCRIPT_IR, SHOT(0, 2),
+    25, INPUT_SOUTH, FIRE(HIT),
+    100, INPUT_BUTTON, 5, INPUT_BUTTON_RELEASE,
+    100, INPUT_BUTTON, 5, INPUT_BUTTON_RELEASE,
+    100, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    25, SCRIPT_IR, REMATCH,
+    100, SCRIPT_END
+};
+
+
+
+/* Player 2 has every part of both ships hit and loses. */
+static const uint8_t lose[] PROGMEM =
+{
+    10, INPUT_NORTH, 10, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    PLACE_SHIPS,
+    50, SCRIPT_IR, SHOT(3, 1), FIRE(MISS),
+    50, SCRIPT_IR, SHOT(3, 2), 25, INPUT_EAST, FIRE(MISS),
+    50, SCRIPT_IR, SHOT(3, 3), 25, INPUT_EAST, FIRE(MISS),
+    50, SCRIPT_IR, SHOT(4, 2),
+    100, SCRIPT_END
+};
+
+
+
+/* Player 1 of the link build. Both boards place their ships in the same
+ * cells and player 1 sinks both of player 2's ships, waiting for each 
+ * of player 2's shots in between. */
+static const uint8_t linkPlayer1[] PROGMEM =
+{
+    10, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    PLACE_SHIPS,
+    FIRE_LINKED, 1, SCRIPT_SYNC,
+    25, INPUT_WEST, FIRE_LINKED, 1, SCRIPT_SYNC,
+    25, INPUT_EAST, 25, INPUT_EAST, FIRE_LINKED, 1, SCRIPT_SYNC,
+    25, INPUT_WEST, 25, INPUT_SOUTH, FIRE_LINKED,
+    100, SCRIPT_END
+};
+
+
+
+/* Player 2 of the link build, who misses above player 1's ships and 
+ * loses. */
+static const uint8_t linkPlayer2[] PROGMEM =
+{
+    10, INPUT_NORTH, 10, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    PLACE_SHIPS,
+    1, SCRIPT_SYNC, 25, INPUT_NORTH, FIRE_LINKED,
+    1, SCRIPT_SYNC, 25, INPUT_EAST, FIRE_LINKED,
+    1, SCRIPT_SYNC, 25, INPUT_EAST, FIRE_LINKED,
+    1, SCRIPT_SYNC,
+    100, SCRIPT_END
+};
+
+
+
+/* Player 1 of the salvo match of the link build, for comparing turn
+ * latency with and without salvos (see SALVO_SHOTS in game.c). Each 
+ * player fires the same 6 shots, as 6 turns of single shots or 2 turns
+ * of 3 shot salvos, so SALVO_SHOTS must be 1, 2, 3 (or 6). Player 1 
+ * hits twice and misses the rest, so the match doesn't end. */
+static const uint8_t salvoPlayer1[] PROGMEM =
+{
+    10, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    PLACE_SHIPS,
+    MARK(INPUT_NONE), TURN_END(1),
+    MARK(INPUT_WEST), TURN_END(2),
+    MARK(INPUT_NORTH), TURN_END(3),
+    MARK(INPUT_EAST), TURN_END(4),
+    MARK(INPUT_EAST), TURN_END(5),
+    MARK(INPUT_NORTH), TURN_END(6),
+    100, SCRIPT_END
+};
+
+
+
+/* Player 2 of the salvo match, who misses every shot. Its last turn 
+ * ends the match, so it only waits for the reply. */
+static const uint8_t salvoPlayer2[] PROGMEM =
+{
+    10, INPUT_NORTH, 10, INPUT_PUSH, 5, INPUT_PUSH_RELEASE,
+    PLACE_SHIPS,
+    FRAME_SYNC_IF(true),
+    MARK(INPUT_NORTH), TURN_END(1),
+    MARK(INPUT_EAST), TURN_END(2),
+    MARK(INPUT_EAST), TURN_END(3),
+    MARK(INPUT_NORTH), TURN_END(4),
+    MARK(INPUT_WEST), TURN_END(5),
+    MARK(INPUT_WEST), SYNC_IF(true),
+    100, SCRIPT_END
+};
+
+
+
+static const uint8_t* const scenarios[SCRIPT_LAST_SCENARIO + 1] PROGMEM =
+{
+    profileGame, edgePlacement, sameCellTwice, winAndRematch, lose,
+    linkPlayer1, linkPlayer2, salvoPlayer1, salvoPlayer2
+};
+
+/* The rest of a scenario from script.c, or 0 for a generated one */
+static const uint8_t* script = 0;
+static bool isStarted = false;
+
+/* The step being played: wait stepWait input samples, then play
+ * stepEvent (with stepByte for SCRIPT_IR) */
+static uint8_t stepWait = 0;
+static uint8_t stepEvent = INPUT_NONE;
+static uint8_t stepByte = 0;
+
+#ifndef SIMLINK
+static uint8_t irQueue[IR_QUEUE_SIZE];
+static uint8_t irHead = 0;
+static uint8_t irTail = 0;
+#endif
+
+/* Bytes read from the opponent that no SCRIPT_SYNC step has waited for */
+static uint8_t irUnsynced = 0;
+
+#ifdef GOLDEN
+/* The generator of a generated scenario: the state of its random 
+ * numbers, the steps left to play, the release due after a press and 
+ * the shots left to send of a salvo */
+static uint16_t generatedRandom = 0;
+static uint8_t generatedSteps = 0;
+static uint8_t generatedRelease = INPUT_NONE;
+static uint8_t generatedShots = 0;
+
+
+
+static uint8_t generatedNext(void)
+/* Returns the low byte of the next number of a 16-bit xorshift 
+ * generator. */
+{
+    generatedRandom ^= generatedRandom << 7;
+    generatedRandom ^= generatedRandom >> 9;
+    generatedRandom ^= generatedRandom << 8;
+    return (uint8_t) generatedRandom;
+}
+
+
+
+static uint8_t generatedShot(void)
+/* Returns a shot at a random cell. */
+{
+    uint8_t row = generatedNext() % BOARD_ROWS;
+
+    return SHOT(row, generatedNext() % BOARD_COLS);
+}
+
+
+
+static uint8_t generatedIrByte(void)
+/* Returns a random byte for the opponent to send: most often a shot or
+ * a reply, sometimes a rematch request or any byte at all. A salvo is
+ * its header, and the shots follow as steps of their own. */
+{
+    uint8_t roll = generatedNext() % 8;
+
+    if (roll < 3) {
+        if (SALVO_SHOTS > 1) {
+            generatedShots = SALVO_SHOTS;
+            return SALVO_HEADER + SALVO_SHOTS;
+        }
+        return generatedShot();
+    }
+    if (roll == 3) {
+        return HIT;
+    }
+    if (roll == 4) {
+        return MISS;
+    }
+    if (roll == 5) {
+        if (SALVO_SHOTS > 1) {
+            return SALVO_REPLY | (generatedNext() & ((1 << (SALVO_SHOTS + NUM_SHIPS)) - 1));
+        }
+        return SUNK_REPLY + generatedNext() % NUM_SHIPS;
+    }
+    if (roll == 6) {
+        return REMATCH;
+    }
+    return generatedNext();
+}
+
+
+
+static void generatedStep(void)
+/* Makes up the next step of a generated scenario: 40% moves, 20% 
+ * presses of the navswitch, 5% presses of the button and 35% bytes
+ * from the opponent. */
+{
+    uint8_t roll = 0;
+
+    stepWait = 1 + generatedNext() % GENERATED_MAX_WAIT;
+    if (generatedRelease != INPUT_NONE) {
+        stepEvent = generatedRelease;
+        generatedRelease = INPUT_NONE;
+        return;
+    }
+    if (generatedShots > 0) {
+        stepWait = 1;
+        stepEvent = SCRIPT_IR;
+        stepByte = generatedShot();
+        generatedShots--;
+        return;
+    }
+    if (generatedSteps == 0) {
+        stepWait = GENERATED_END_WAIT;
+        stepEvent = SCRIPT_END;
+        return;
+    }
+    generatedSteps--;
+
+    roll = generatedNext() % 20;
+    if (roll < 8) {
+        stepEvent = INPUT_NORTH + roll % 4;
+    } else if (roll < 12) {
+        stepEvent = INPUT_PUSH;
+        generatedRelease = INPUT_PUSH_RELEASE;
+    } else if (roll < 13) {
+        stepEvent = INPUT_BUTTON;
+        generatedRelease = INPUT_BUTTON_RELEASE;
+    } else {
+        stepEvent = SCRIPT_IR;
+        stepByte = generatedIrByte();
+    }
+}
+
+
+
+static void generatedStart(uint16_t scenario)
+/* Seeds the generator with the scenario number (never 0, which xorshift
+ * can't leave). */
+{
+    uint8_t i = 0;
+
+    generatedRandom = scenario;
+    for (i = 0; i < GENERATED_WARM_UP; i++) {
+        generatedNext();
+    }
+    generatedSteps = GENERATED_STEPS;
+    script = 0;
+}
+#endif /* GOLDEN */
+
+
+
+static void stepNext(void)
+/* Moves on to the next step of the scenario. */
+{
+#ifdef GOLDEN
+    if (script == 0) {
+        generatedStep();
+        return;
+    }
+#endif
+    stepWait = pgm_read_byte(script);
+    stepEvent = pgm_read_byte(script + 1);
+    script += 2;
+    if (stepEvent == SCRIPT_IR) {
+        stepByte = pgm_read_byte(script);
+        script++;
+    }
+}
+
+
+
+static void scriptStart(void)
+/* Picks the scenario to play. The golden and link builds read it from
+ * EEPROM, anything else plays scenario 0. */
+{
+    uint16_t scenario = 0;
+
+#if defined(GOLDEN) || defined(SIMLINK)
+    scenario = eeprom_read_word((const uint16_t*) SCRIPT_SCENARIO_ADDRESS);
+#endif
+#ifdef GOLDEN
+    if (scenario >= SCRIPT_GENERATED && scenario != SCRIPT_ERASED) {
+        generatedStart(scenario);
+        stepNext();
+        return;
+    }
+#endif
+    if (scenario > SCRIPT_LAST_SCENARIO) {
+        scenario = 0;
+    }
+    script = pgm_read_ptr(&scenarios[scenario]);
+    stepNext();
+}
+
+
+
+uint8_t scriptEvent(void)
+/* Plays the next input sample of the script. Returns the input event
+ * for this sample, or INPUT_NONE if there isn't one. Stops the
+ * simulator once the script has finished. */
+{
+    static uint8_t waited = 0;
+    uint8_t event = INPUT_NONE;
+
+    if (!isStarted) {
+        scriptStart();
+        isStarted = true;
+    }
+    if (waited < stepWait) {
+        waited++;
+    }
+    if (waited < stepWait) {
+        return INPUT_NONE;
+    }
+    event = stepEvent;
+    if (event == SCRIPT_SYNC) {
+        /* Stay on this step until the opponent's byte has been read */
+        if (irUnsynced == 0) {
+            return INPUT_NONE;
+        }
+        irUnsynced--;
+    }
+    if (event == SCRIPT_END) {
+        /* simavr exits (writing out the VCD file) when the cpu sleeps
+         * with interrupts off, as does the native build */
+        cli();
+        sleep_enable();
+        sleep_cpu();
+    }
+    waited = 0;
+
+    if (event == SCRIPT_IR) {
+#ifndef SIMLINK
+        /* A byte that finds the queue full is lost, as it would be */
+        if (((irTail + 1) & IR_QUEUE_MASK) != irHead) {
+            irQueue[irTail] = stepByte;
+            irTail = (irTail + 1) & IR_QUEUE_MASK;
+        }
+#endif
+        event = INPUT_NONE;
+    } else if (event == SCRIPT_SYNC) {
+        event = INPUT_NONE;
+    }
+    stepNext();
+    return event;
+}
+
+
+
+bool scriptIrReady(void)
+/* Returns true if the opponent has sent a byte that has not been read. */
+{
+#if defined(SIMLINK) && defined(NATIVE)
+    return nativeLinkReady();
+#elif defined(SIMLINK)
+    return _SFR_MEM8(SCRIPT_LINK_STATUS) != 0;
+#else
+    return irHead != irTail;
+#endif
+}
+
+
+
+uint8_t scriptIrGetc(void)
+/* Returns the next byte sent by the opponent. */
+{
+    uint8_t byte = 0;
+
+#if defined(SIMLINK) && defined(NATIVE)
+    byte = nativeLinkGetc();
+#elif defined(SIMLINK)
+    byte = _SFR_MEM8(SCRIPT_LINK_DATA);
+#else
+    byte = irQueue[irHead];
+    irHead = (irHead + 1) & IR_QUEUE_MASK;
+#endif
+    if (irUnsynced < UINT8_MAX) {
+        irUnsynced++;
+    }
+    return byte;
+}
+
+
+
+void scriptIrPutc(uint8_t byte)
+/* Sends a byte to the opponent. The golden build records it for the
+ * golden runner and the link build hands it to link_run. */
+{
+#if defined(GOLDEN) && defined(NATIVE)
+    nativeIrSent(byte);
+#elif defined(GOLDEN)
+    /* Back to 0 after each byte, so that repeated bytes show up */
+    GPIOR1 = byte;
+    GPIOR1 = 0;
+#elif defined(SIMLINK) && defined(NATIVE)
+    nativeLinkPutc(byte);
+#elif defined(SIMLINK)
+    _SFR_MEM8(SCRIPT_LINK_DATA) = byte;
+#else
+    (void) byte;
+#endif
+}
+
+#endif /* SCRIPT */
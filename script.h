@@ -0,0 +1,90 @@
+/** FILE: script.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Scripted games for running the game under the simavr 
+ * simulator, where there are no switches to press and no other board
+ * to talk to. A script plays the player, through the input task, and 
+ * the opponent, through the IR link (see link.h). Only built in when 
+ * SCRIPT is defined, which the profiling, golden and link builds do 
+ * (see profile.h, golden.c and link_run.c).
+ *
+ * A script is a list of steps in flash. Each step waits a number of 
+ * input samples then either queues an input event (see input.h), 
+ * receives a byte from the opponent (SCRIPT_IR followed by the byte), 
+ * waits until a byte from the opponent has been read (SCRIPT_SYNC) or
+ * stops the simulator (SCRIPT_END).
+ *
+ * In the link build (SIMLINK) the opponent is another simulated board 
+ * played by its own script, so SCRIPT_IR steps are ignored and the 
+ * bytes go through two registers that link_run watches.
+ *
+ * The golden and link builds also run natively, without simavr (see
+ * host/native.h), where the bytes go to the native board instead.
+ */
+
+
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SCRIPT_SYNC 0xfd
+#define SCRIPT_IR 0xfe
+#define SCRIPT_END 0xff
+
+/* Scenario 0 is the game that is profiled. The golden runner runs the
+ * first SCRIPT_NUM_SCENARIOS, which play against the script. The pairs
+ * after them play a match against each other in the link build: one
+ * where player 1 sinks both ships, and one for comparing turn latency 
+ * with and without salvos. */
+#define SCRIPT_NUM_SCENARIOS 5
+#define SCRIPT_LINK_PLAYER_1 SCRIPT_NUM_SCENARIOS
+#define SCRIPT_LINK_PLAYER_2 (SCRIPT_NUM_SCENARIOS + 1)
+#define SCRIPT_SALVO_PLAYER_1 (SCRIPT_NUM_SCENARIOS + 2)
+#define SCRIPT_SALVO_PLAYER_2 (SCRIPT_NUM_SCENARIOS + 3)
+#define SCRIPT_LAST_SCENARIO SCRIPT_SALVO_PLAYER_2
+
+/* In the golden build, scenarios from SCRIPT_GENERATED up (to 0xfffe) 
+ * are not in flash but made up as they are played, from random numbers
+ * seeded with the scenario number: random presses and moves, and random
+ * bytes from the opponent, mostly shots and replies. The golden runner
+ * runs thousands of them (see golden_run.c). */
+#define SCRIPT_GENERATED 0x100
+#define SCRIPT_ERASED 0xffff
+
+/* The golden runner and link_run choose the scenario with this EEPROM 
+ * word (low byte first). It is past the snapshots (see snapshot.h). */
+#define SCRIPT_SCENARIO_ADDRESS 0x3fe
+
+/* The registers of the IR link in the link build, as data addresses. 
+ * Writing SCRIPT_LINK_DATA (GPIOR1) sends a byte and reading it takes 
+ * the next byte received. SCRIPT_LINK_STATUS (GPIOR2) reads as non-zero
+ * while there is a byte to take. */
+#define SCRIPT_LINK_DATA 0x4a
+#define SCRIPT_LINK_STATUS 0x4b
+
+
+
+uint8_t scriptEvent(void);
+/* Plays the next input sample of the script. Returns the input event 
+ * for this sample, or INPUT_NONE if there isn't one. Stops the 
+ * simulator once the script has finished. */
+
+
+
+bool scriptIrReady(void);
+/* Returns true if the opponent has sent a byte that has not been read. */
+
+
+
+uint8_t scriptIrGetc(void);
+/* Returns the next byte sent by the opponent. */
+
+
+
+void scriptIrPutc(uint8_t byte);
+/* Sends a byte to the opponent. The golden build records it for the 
+ * golden runner and the link build hands it to link_run. */
+
+#endif /* SCRIPT_H */
@@ -0,0 +1,272 @@
+/** FILE: snapshot.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Saves the state of a match to EEPROM so that it can be
+ * resumed after a reset or brown-out. See snapshot.h.
+ */
+
+#include "snapshot.h"
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__AVR__) || defined(NATIVE)
+#include <avr/eeprom.h>
+#else
+#include <stdio.h>
+#endif
+
+#define CRC_POLYNOMIAL 0x07
+
+/* The checksum is the last byte of a slot. It is offset so that an
+ * erased slot (all 0xff) is not valid. */
+#define CHECKSUM_BYTE (SNAPSHOT_BYTES - 1)
+#define CHECKSUM_OFFSET 0xff
+
+/* The slot the next snapshot is written to, and its sequence number */
+static uint8_t nextSlot = 0;
+static uint8_t nextSequence = 0;
+
+/* The snapshot being written by snapshotWrite, and how many of its 
+ * bytes have been written (SNAPSHOT_BYTES once it is all written) */
+static uint8_t pendingBytes[SNAPSHOT_BYTES];
+static uint8_t* pendingAddress = 0;
+static uint8_t numWritten = SNAPSHOT_BYTES;
+
+
+
+#if !defined(__AVR__) && !defined(NATIVE)
+/* Host tools (see snapshot_dump.c) keep the EEPROM in a file. The
+ * native build has its own EEPROM (see host/avr/eeprom.h). */
+const char* snapshotFileName = "snapshot.eeprom";
+
+
+
+static void eeprom_read_block(void* destination, const void* source, size_t length)
+/* Reads from the EEPROM image file. Bytes past the end of the file
+ * read as 0xff, like erased EEPROM. */
+{
+    FILE* file = fopen(snapshotFileName, "rb");
+    size_t numRead = 0;
+
+    if (file != 0) {
+        fseek(file, (long) (size_t) source, SEEK_SET);
+        numRead = fread(destination, 1, length, file);
+        fclose(file);
+    }
+    memset((uint8_t*) destination + numRead, 0xff, length - numRead);
+}
+
+
+
+static void eeprom_update_byte(uint8_t* destination, uint8_t value)
+/* Writes to the EEPROM image file, creating it if needed. */
+{
+    FILE* file = fopen(snapshotFileName, "r+b");
+
+    if (file == 0) {
+        file = fopen(snapshotFileName, "w+b");
+    }
+    if (file != 0) {
+        fseek(file, (long) (size_t) destination, SEEK_SET);
+        fputc(value, file);
+        fclose(file);
+    }
+}
+
+
+
+/* Writes to the file finish straight away */
+#define eeprom_is_ready() true
+#endif
+
+
+
+uint8_t snapshotHash(const uint8_t* bytes, uint8_t length)
+/* Returns an 8-bit CRC of length bytes. */
+{
+    uint8_t crc = 0;
+    uint8_t bit = 0;
+
+    while (length > 0) {
+        crc ^= *bytes;
+        for (bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ CRC_POLYNOMIAL : crc << 1;
+        }
+        bytes++;
+        length--;
+    }
+    return crc;
+}
+
+
+
+static void bitsPut(uint8_t* bytes, uint8_t* position, uint8_t value, uint8_t numBits)
+/* Writes the low numBits bits of value at bit position in bytes, and
+ * moves position on. bytes must start out cleared. */
+{
+    while (numBits > 0) {
+        if (value & 1) {
+            bytes[*position >> 3] |= 1 << (*position & 7);
+        }
+        value >>= 1;
+        (*position)++;
+        numBits--;
+    }
+}
+
+
+
+static uint8_t bitsGet(const uint8_t* bytes, uint8_t* position, uint8_t numBits)
+/* Reads numBits bits from bit position in bytes, and moves position on. */
+{
+    uint8_t value = 0;
+    uint8_t bit = 0;
+
+    for (bit = 0; bit < numBits; bit++) {
+        if (bytes[*position >> 3] & (1 << (*position & 7))) {
+            value |= 1 << bit;
+        }
+        (*position)++;
+    }
+    return value;
+}
+
+
+
+static void boardPut(uint8_t* bytes, uint8_t* position, const uint8_t board[])
+/* Writes an int matrix of SNAPSHOT_COLS columns with bitsPut. */
+{
+    uint8_t column = 0;
+
+    for (column = 0; column < SNAPSHOT_COLS; column++) {
+        bitsPut(bytes, position, board[column], SNAPSHOT_ROWS);
+    }
+}
+
+
+
+static void boardGet(const uint8_t* bytes, uint8_t* position, uint8_t board[])
+/* Reads an int matrix of SNAPSHOT_COLS columns with bitsGet. */
+{
+    uint8_t column = 0;
+
+    for (column = 0; column < SNAPSHOT_COLS; column++) {
+        board[column] = bitsGet(bytes, position, SNAPSHOT_ROWS);
+    }
+}
+
+
+
+static uint8_t* slotAddress(uint8_t slot)
+/* Returns the EEPROM address of slot. */
+{
+    return (uint8_t*) (size_t) (SNAPSHOT_ADDRESS + slot * SNAPSHOT_BYTES);
+}
+
+
+
+static bool slotRead(uint8_t slot, Snapshot* snapshot)
+/* Unpacks the snapshot in slot. Returns false if its checksum is wrong
+ * (e.g the slot is erased or a write was cut short). */
+{
+    uint8_t bytes[SNAPSHOT_BYTES];
+    uint8_t position = 8;
+    uint8_t checksum = 0;
+
+    eeprom_read_block(bytes, slotAddress(slot), SNAPSHOT_BYTES);
+    checksum = snapshotHash(bytes, CHECKSUM_BYTE) ^ CHECKSUM_OFFSET;
+    if (checksum != bytes[CHECKSUM_BYTE]) {
+        return false;
+    }
+    snapshot->sequence = bytes[0];
+    snapshot->phase = bitsGet(bytes, &position, 2);
+    snapshot->playerNum = bitsGet(bytes, &position, 1) + 1;
+    snapshot->isLastMoveHit = bitsGet(bytes, &position, 1);
+    snapshot->turns = bitsGet(bytes, &position, 8);
+    boardGet(bytes, &position, snapshot->fleet);
+    boardGet(bytes, &position, snapshot->afloat);
+    boardGet(bytes, &position, snapshot->hitMatrix);
+    boardGet(bytes, &position, snapshot->missMatrix);
+    snapshot->shipRow = bitsGet(bytes, &position, 3);
+    snapshot->shipColumn = bitsGet(bytes, &position, 3);
+    snapshot->opponentSunk = bitsGet(bytes, &position, 2);
+    return true;
+}
+
+
+
+bool snapshotLoad(Snapshot* snapshot)
+/* Finds the newest valid snapshot and copies it into snapshot. Returns
+ * false if there is none. Must be called before snapshotSave, so that
+ * it knows which slot to write next. */
+{
+    Snapshot slotSnapshot;
+    bool isFound = false;
+    uint8_t slot = 0;
+
+    for (slot = 0; slot < SNAPSHOT_SLOTS; slot++) {
+        /* Sequence numbers wrap, so compare them by their difference */
+        if (slotRead(slot, &slotSnapshot)
+            && (!isFound || (int8_t) (slotSnapshot.sequence - snapshot->sequence) > 0)) {
+            *snapshot = slotSnapshot;
+            nextSlot = (slot + 1) % SNAPSHOT_SLOTS;
+            isFound = true;
+        }
+    }
+    nextSequence = isFound ? snapshot->sequence + 1 : 0;
+    return isFound;
+}
+
+
+
+bool snapshotWrite(void)
+/* Writes the next byte of the snapshot being saved, if the EEPROM has
+ * finished writing the last one. Returns true while there are bytes
+ * left to write. */
+{
+    if (numWritten < SNAPSHOT_BYTES && eeprom_is_ready()) {
+        /* Only starts a write (3.4 ms) if the byte has changed */
+        eeprom_update_byte(pendingAddress + numWritten, pendingBytes[numWritten]);
+        numWritten++;
+    }
+    return numWritten < SNAPSHOT_BYTES;
+}
+
+
+
+void snapshotSave(Snapshot* snapshot)
+/* Gives snapshot the next sequence number and starts writing it to the
+ * next slot (see snapshotWrite). */
+{
+    uint8_t* bytes = pendingBytes;
+    uint8_t position = 8;
+
+    /* Finish the last snapshot first, so that it is not left without 
+     * its checksum */
+    while (snapshotWrite()) {
+        continue;
+    }
+    memset(bytes, 0, SNAPSHOT_BYTES);
+
+    snapshot->sequence = nextSequence;
+    bytes[0] = snapshot->sequence;
+    bitsPut(bytes, &position, snapshot->phase, 2);
+    bitsPut(bytes, &position, snapshot->playerNum - 1, 1);
+    bitsPut(bytes, &position, snapshot->isLastMoveHit, 1);
+    bitsPut(bytes, &position, snapshot->turns, 8);
+    boardPut(bytes, &position, snapshot->fleet);
+    boardPut(bytes, &position, snapshot->afloat);
+    boardPut(bytes, &position, snapshot->hitMatrix);
+    boardPut(bytes, &position, snapshot->missMatrix);
+    bitsPut(bytes, &position, snapshot->shipRow, 3);
+    bitsPut(bytes, &position, snapshot->shipColumn, 3);
+    bitsPut(bytes, &position, snapshot->opponentSunk, 2);
+    bytes[CHECKSUM_BYTE] = snapshotHash(bytes, CHECKSUM_BYTE) ^ CHECKSUM_OFFSET;
+
+    /* The checksum is the last byte written, so the slot only becomes 
+     * valid once all of it has been written */
+    pendingAddress = slotAddress(nextSlot);
+    numWritten = 0;
+    nextSlot = (nextSlot + 1) % SNAPSHOT_SLOTS;
+    nextSequence++;
+}
@@ -0,0 +1,91 @@
+/** FILE: snapshot.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Saves the state of a match to EEPROM so that it can be
+ * resumed after a reset or brown-out. A snapshot is bit-packed into
+ * SNAPSHOT_BYTES bytes and written to the next of SNAPSHOT_SLOTS slots
+ * each time, so the writes are spread over the slots (wear levelling).
+ * Only bytes that have changed are written.
+ *
+ * Writing a byte of EEPROM takes 3.4 ms, so snapshotSave only packs the
+ * snapshot and snapshotWrite writes it a byte at a time, without 
+ * waiting, each time it is called. The checksum byte is written last, 
+ * so a slot cut short by a reset is never taken as valid.
+ *
+ * When built for the host (see snapshot_dump.c) the EEPROM is a file,
+ * snapshotFileName, e.g an EEPROM image read back from a board.
+ */
+
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* The size of the board, must match the LED matrix */
+#define SNAPSHOT_COLS 5
+#define SNAPSHOT_ROWS 7
+
+/* Sequence, phase/player/flags, turns, 4 boards of 35 bits, the short
+ * ship and sunk ships, checksum */
+#define SNAPSHOT_BYTES 22
+#define SNAPSHOT_SLOTS 8
+
+/* Where the slots start in EEPROM */
+#define SNAPSHOT_ADDRESS 0
+
+
+
+/* The state of a match. Columns of the boards are int matrix columns
+ * (see int_matrix.h). */
+typedef struct snapshot_s
+{
+    uint8_t sequence;       /* Set by snapshotSave */
+    uint8_t phase;          /* 0 to 3 */
+    uint8_t playerNum;      /* 1 or 2 */
+    bool isLastMoveHit;
+    uint8_t turns;          /* Number of shots (or salvos) exchanged */
+    uint8_t fleet[SNAPSHOT_COLS];       /* Where our ships were placed */
+    uint8_t afloat[SNAPSHOT_COLS];      /* The parts of our ships not hit yet */
+    uint8_t hitMatrix[SNAPSHOT_COLS];   /* Our shots that hit */
+    uint8_t missMatrix[SNAPSHOT_COLS];  /* Our shots that missed */
+    /* Where our one-cell ship is, the rest of the fleet is the other ship */
+    uint8_t shipRow;
+    uint8_t shipColumn;
+    uint8_t opponentSunk;   /* Bit i set if the opponent's ship i is sunk */
+
+} Snapshot;
+
+
+
+#if !defined(__AVR__) && !defined(NATIVE)
+extern const char* snapshotFileName;
+#endif
+
+
+
+bool snapshotLoad(Snapshot* snapshot);
+/* Finds the newest valid snapshot and copies it into snapshot. Returns
+ * false if there is none. Must be called before snapshotSave, so that
+ * it knows which slot to write next. */
+
+
+
+void snapshotSave(Snapshot* snapshot);
+/* Gives snapshot the next sequence number and starts writing it to the
+ * next slot (see snapshotWrite). */
+
+
+
+bool snapshotWrite(void);
+/* Writes the next byte of the snapshot being saved, if the EEPROM has
+ * finished writing the last one. Returns true while there are bytes
+ * left to write. Call this often, e.g on every tick. */
+
+
+
+uint8_t snapshotHash(const uint8_t* bytes, uint8_t length);
+/* Returns an 8-bit CRC of length bytes. */
+
+#endif /* SNAPSHOT_H */
@@ -0,0 +1,67 @@
+/** FILE: snapshot_dump.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host program that prints the newest match snapshot (see
+ * snapshot.h) in an EEPROM image, e.g one read back from a board.
+ *
+ * Usage: snapshot_dump [snapshot.eeprom]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "snapshot.h"
+
+
+
+static const char* phaseNames[] = {"placement", "fire", "waiting", "end"};
+
+
+
+static void boardsPrint(const Snapshot* snapshot)
+/* Prints our fleet (# afloat, x hit) next to our shots (* hit, o miss). */
+{
+    int row = 0;
+    int column = 0;
+    uint8_t bit = 0;
+
+    printf("fleet  shots\n");
+    for (row = 0; row < SNAPSHOT_ROWS; row++) {
+        bit = 1 << row;
+        for (column = 0; column < SNAPSHOT_COLS; column++) {
+            putchar(snapshot->afloat[column] & bit ? '#' : snapshot->fleet[column] & bit ? 'x' : '.');
+        }
+        printf("  ");
+        for (column = 0; column < SNAPSHOT_COLS; column++) {
+            putchar(snapshot->hitMatrix[column] & bit ? '*' : snapshot->missMatrix[column] & bit ? 'o' : '.');
+        }
+        putchar('\n');
+    }
+}
+
+
+
+int main(int argc, char* argv[])
+{
+    Snapshot snapshot;
+
+    if (argc > 2) {
+        fprintf(stderr, "usage: %s [snapshot.eeprom]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (argc == 2) {
+        snapshotFileName = argv[1];
+    }
+    if (!snapshotLoad(&snapshot)) {
+        fprintf(stderr, "%s: no valid snapshot\n", snapshotFileName);
+        return EXIT_FAILURE;
+    }
+
+    printf("sequence %u, player %u, phase %s, turns %u, last shot %s\n",
+           snapshot.sequence, snapshot.playerNum, phaseNames[snapshot.phase],
+           snapshot.turns, snapshot.isLastMoveHit ? "hit" : "missed");
+    printf("one-cell ship at row %u column %u, opponent's ships sunk: long %s, short %s\n",
+           snapshot.shipRow, snapshot.shipColumn, snapshot.opponentSunk & 1 ? "yes" : "no",
+           snapshot.opponentSunk & 2 ? "yes" : "no");
+    boardsPrint(&snapshot);
+    return EXIT_SUCCESS;
+}
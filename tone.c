@@ -0,0 +1,67 @@
+/** FILE: tone.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Generates a square wave on the piezo pin in hardware,
+ * using the timer 1 compare B interrupt. The note only has to be set
+ * when it changes, so no task needs to run at the audio rate.
+ */
+
+#include "tone.h"
+#include "tone_scale.h"
+#include "pio.h"
+#include "timer.h"
+#include "profile.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+/* Timer 1 is free running (it is the scheduler's clock), so rather
+ * than using a PWM mode the compare register is moved on by half a
+ * period each time it matches. */
+static volatile uint16_t halfPeriod = 0;
+
+
+
+ISR(TIMER1_COMPB_vect)
+/* Toggles the piezo pin every half period. */
+{
+    PROFILE_BEGIN(PROFILE_TONE_ISR);
+    OCR1B += halfPeriod;
+    pio_output_toggle(PIEZO_PIO);
+    PROFILE_END();
+}
+
+
+
+void toneInit(void)
+/* Sets up the piezo pin and enables interrupts. The timer itself is
+ * started by the task scheduler. */
+{
+    pio_config_set(PIEZO_PIO, PIO_OUTPUT_LOW);
+    TIMSK1 &= ~(1 << OCIE1B);
+    sei();
+}
+
+
+
+void toneNotePlay(void* data, uint8_t note, uint8_t velocity)
+/* Starts playing a MIDI note number, or stops the sound if velocity
+ * is 0. Matches melodyCallback_t, data is unused. */
+{
+    (void) data;
+
+    if (velocity == 0) {
+        TIMSK1 &= ~(1 << OCIE1B);
+        pio_output_low(PIEZO_PIO);
+        return;
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        halfPeriod = toneHalfPeriod(note);
+        if (!(TIMSK1 & (1 << OCIE1B))) {
+            OCR1B = TCNT1 + halfPeriod;
+            TIFR1 = (1 << OCF1B);
+            TIMSK1 |= (1 << OCIE1B);
+        }
+    }
+}
@@ -0,0 +1,32 @@
+/** FILE: tone.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Generates a square wave on the piezo pin in hardware,
+ * using the timer 1 compare B interrupt. The note only has to be set
+ * when it changes, so no task needs to run at the audio rate.
+ */
+
+
+#ifndef TONE_H
+#define TONE_H
+
+#include "system.h"
+#include "pio.h"
+#include "timer.h"
+#include "tone_scale.h"
+
+#define PIEZO_PIO PIO_DEFINE (PORT_D, 6)
+
+
+
+void toneInit(void);
+/* Sets up the piezo pin and enables interrupts. The timer itself is
+ * started by the task scheduler. */
+
+
+
+void toneNotePlay(void* data, uint8_t note, uint8_t velocity);
+/* Starts playing a MIDI note number, or stops the sound if velocity
+ * is 0. Matches melodyCallback_t, data is unused. */
+
+#endif /* TONE_H */
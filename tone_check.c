@@ -0,0 +1,154 @@
+/** FILE: tone_check.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host program that checks the piezo pitches of
+ * tone_scale.c ("make tone-check"). Each half period is turned back
+ * into a frequency from F_CPU and the timer 1 prescaler and compared
+ * against equal temperament (A4 = 440 Hz).
+ *
+ * The octave 0 table must be within TONE_CHECK_CENTS of each note.
+ * Timer 1 only counts in whole ticks (TIMER_RATE a second), so higher
+ * notes can't be that close. Instead every note a tune can use must be
+ * within TONE_CHECK_CENTS of the nearest pitch the timer can make,
+ * which catches mistakes in the table, the octave shifts and the
+ * rounding. The notes the tunes actually play must also be within
+ * TONE_CHECK_TUNE_CENTS of the true note, so that none of them sounds
+ * like a different note.
+ *
+ * Usage: tone_check
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "melody.h"
+#include "tunes.h"
+#include "tone_scale.h"
+
+#if TIMER_RATE * TIMER_CLOCK_DIVISOR != F_CPU
+#error "TIMER_RATE does not match F_CPU and TIMER_CLOCK_DIVISOR"
+#endif
+
+#define TONE_CHECK_CENTS 1.0
+#define TONE_CHECK_TUNE_CENTS 50.0
+
+/* MIDI note numbers of A4, and of C0 (the first note of the table) */
+#define MIDI_A4 69
+#define MIDI_C0 12
+#define A4_HZ 440.0
+#define CENTS_PER_OCTAVE 1200.0
+
+/* What tone.c sounds: the pin toggles every half period */
+#define TIMER_HZ ((double) F_CPU / TIMER_CLOCK_DIVISOR)
+
+
+
+static double noteHz(int note)
+/* Returns the equal temperament frequency of a MIDI note number. */
+{
+    return A4_HZ * pow(2.0, (note - MIDI_A4) / (double) TONE_NOTES_PER_OCTAVE);
+}
+
+
+
+static double centsBetween(double hz, double targetHz)
+{
+    return CENTS_PER_OCTAVE * log2(hz / targetHz);
+}
+
+
+
+static bool tableCheck(void)
+/* Checks the octave 0 table, which is scaled by 16. */
+{
+    static const uint16_t table[TONE_NOTES_PER_OCTAVE] = TONE_SCALE_TABLE;
+    bool isOk = true;
+    double cents = 0;
+    int note = 0;
+
+    for (note = 0; note < TONE_NOTES_PER_OCTAVE; note++) {
+        cents = centsBetween(TIMER_HZ * 16 / (2.0 * table[note]), noteHz(MIDI_C0 + note));
+        if (fabs(cents) > TONE_CHECK_CENTS) {
+            printf("table entry %d is %+.2f cents out\n", note, cents);
+            isOk = false;
+        }
+    }
+    return isOk;
+}
+
+
+
+static bool noteCheck(int note, double* cents)
+/* Checks the half period of note against the nearest one the timer
+ * can make, and sets cents to how far it is from the true note. */
+{
+    uint16_t halfPeriod = toneHalfPeriod(note);
+    double hz = TIMER_HZ / (2.0 * halfPeriod);
+    double bestHz = TIMER_HZ / (2.0 * lround(TIMER_HZ / (2.0 * noteHz(note))));
+    double error = centsBetween(hz, bestHz);
+
+    *cents = centsBetween(hz, noteHz(note));
+    if (fabs(error) > TONE_CHECK_CENTS) {
+        printf("note %d: half period %u is %+.2f cents from the nearest the timer can make\n",
+               note, halfPeriod, error);
+        return false;
+    }
+    return true;
+}
+
+
+
+static bool tuneCheck(const char* name, const uint8_t* tune)
+/* Checks the notes that tune plays and prints the worst of them. */
+{
+    const uint8_t* code = tune + 1;
+    bool isOk = true;
+    double cents = 0;
+    double worst = 0;
+    int worstNote = 0;
+    int note = 0;
+
+    for (; *code != MELODY_END && *code != MELODY_LOOP; code++) {
+        if ((*code & MELODY_NOTE_MASK) == MELODY_REST_NOTE) {
+            continue;
+        }
+        note = MELODY_BASE_NOTE + (*code & MELODY_NOTE_MASK);
+        noteCheck(note, &cents);
+        if (fabs(cents) > fabs(worst)) {
+            worst = cents;
+            worstNote = note;
+        }
+    }
+    printf("%-6s worst note %d, %+.1f cents\n", name, worstNote, worst);
+    if (fabs(worst) > TONE_CHECK_TUNE_CENTS) {
+        printf("%s: note %d is more than %.0f cents out\n", name, worstNote, TONE_CHECK_TUNE_CENTS);
+        isOk = false;
+    }
+    return isOk;
+}
+
+
+
+int main(void)
+{
+    bool isOk = tableCheck();
+    double cents = 0;
+    int note = 0;
+
+    for (note = MELODY_BASE_NOTE; note < MELODY_BASE_NOTE + MELODY_REST_NOTE; note++) {
+        if (!noteCheck(note, &cents)) {
+            isOk = false;
+        }
+    }
+    isOk = tuneCheck("theme", themeTune) && isOk;
+    isOk = tuneCheck("hit", hitTune) && isOk;
+    isOk = tuneCheck("miss", missTune) && isOk;
+    isOk = tuneCheck("sunk", sunkTune) && isOk;
+    isOk = tuneCheck("win", winTune) && isOk;
+    isOk = tuneCheck("lose", loseTune) && isOk;
+
+    printf("%s\n", isOk ? "all pitches ok" : "pitch check FAILED");
+    return isOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
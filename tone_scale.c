@@ -0,0 +1,24 @@
+/** FILE: tone_scale.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Converts MIDI note numbers into half periods of the
+ * timer 1 clock, for the piezo tone generator.
+ */
+
+#include "tone_scale.h"
+#include "flash.h"
+
+static const uint16_t scaleTable[TONE_NOTES_PER_OCTAVE] PROGMEM = TONE_SCALE_TABLE;
+
+
+
+uint16_t toneHalfPeriod(uint8_t note)
+/* Returns half the period, in timer ticks, of a MIDI note number. */
+{
+    uint8_t octave = note / TONE_NOTES_PER_OCTAVE;
+    uint16_t halfPeriodX16 = pgm_read_word(&scaleTable[note - octave * TONE_NOTES_PER_OCTAVE]);
+
+    /* MIDI octave 0 is C-1, one octave below the table */
+    octave = octave > 0 ? octave - 1 : 0;
+    return ((halfPeriodX16 >> octave) + 8) >> 4;
+}
@@ -0,0 +1,43 @@
+/** FILE: tone_scale.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Converts MIDI note numbers into half periods of the
+ * timer 1 clock, for the piezo tone generator.
+ */
+
+
+#ifndef TONE_SCALE_H
+#define TONE_SCALE_H
+
+#include <stdint.h>
+
+/* On the host TIMER_RATE is given on the command line instead */
+#ifdef __AVR__
+#include "timer.h"
+#endif
+
+#define TONE_NOTES_PER_OCTAVE 12
+
+/* Half the period, in timer ticks and scaled by 16, of a note with a
+ * frequency of FREQ_MHZ millihertz. */
+#define TONE_HALF_PERIOD_X16(FREQ_MHZ) \
+    ((uint16_t) (((uint32_t) TIMER_RATE * 8000 + (FREQ_MHZ) / 2) / (FREQ_MHZ)))
+
+/* Half periods of the notes in octave 0 (C0 to B0). Higher octaves
+ * are found by halving. */
+#define TONE_SCALE_TABLE \
+{ \
+    TONE_HALF_PERIOD_X16(16352), TONE_HALF_PERIOD_X16(17324), \
+    TONE_HALF_PERIOD_X16(18354), TONE_HALF_PERIOD_X16(19445), \
+    TONE_HALF_PERIOD_X16(20602), TONE_HALF_PERIOD_X16(21827), \
+    TONE_HALF_PERIOD_X16(23125), TONE_HALF_PERIOD_X16(24500), \
+    TONE_HALF_PERIOD_X16(25957), TONE_HALF_PERIOD_X16(27500), \
+    TONE_HALF_PERIOD_X16(29135), TONE_HALF_PERIOD_X16(30868) \
+}
+
+
+
+uint16_t toneHalfPeriod(uint8_t note);
+/* Returns half the period, in timer ticks, of a MIDI note number. */
+
+#endif /* TONE_SCALE_H */
@@ -0,0 +1,48 @@
+/** FILE: trace.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: A timeline trace of the game, kept in a small ring 
+ * buffer in SRAM. See trace.h.
+ */
+
+#include "trace.h"
+
+#ifdef TRACE
+
+#include "timer.h"
+
+#define TRACE_MASK (TRACE_SIZE - 1)
+
+TraceBuffer traceBuffer;
+
+
+
+void traceRecord(uint8_t kind, uint8_t arg)
+/* Adds an event to the trace, overwriting the oldest event if it is full. */
+{
+    TraceEvent* event = &traceBuffer.events[traceBuffer.next];
+
+    event->kind = kind;
+    event->arg = arg;
+    event->time = timer_get();
+
+    traceBuffer.next = (traceBuffer.next + 1) & TRACE_MASK;
+    if (traceBuffer.next == 0) {
+        traceBuffer.isFull = 1;
+    }
+}
+
+
+
+void traceWaitMark(void)
+/* Records TRACE_WAIT if nothing has been recorded for TRACE_WAIT_TICKS.
+ * Call often from loops that wait without recording anything. */
+{
+    const TraceEvent* last = &traceBuffer.events[(traceBuffer.next - 1) & TRACE_MASK];
+
+    if ((timer_tick_t) (timer_get() - last->time) >= TRACE_WAIT_TICKS) {
+        traceRecord(TRACE_WAIT, 0);
+    }
+}
+
+#endif /* TRACE */
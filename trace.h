@@ -0,0 +1,103 @@
+/** FILE: trace.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: A timeline trace of the game, kept in a small ring 
+ * buffer in SRAM: task begin/end, phase changes, IR bytes and shot 
+ * results, each stamped with the timer 1 tick. Only built in when 
+ * TRACE is defined (make DEBUG_CFLAGS=-DTRACE).
+ *
+ * While a match is being played about 1000 events are recorded a second
+ * (each run of the game, tune, communication and input tasks is a 
+ * begin and an end), so the buffer holds the last TRACE_SIZE ms or so.
+ * The default of 32 events (130 bytes of SRAM) is too short to see a 
+ * whole IR round trip; make DEBUG_CFLAGS="-DTRACE -DTRACE_SIZE=128" 
+ * keeps about 1/8 s for 514 bytes. Busy-waits that 
+ * run no tasks (e.g recordShot waiting for a reply) record nothing but
+ * TRACE_WAIT, so they stretch the window.
+ *
+ * To look at a trace, stop the program in a debugger (e.g simavr -g 
+ * with avr-gdb) and save the buffer with
+ *     dump binary memory trace.bin &traceBuffer (char*) &traceBuffer + sizeof traceBuffer
+ * then convert it with "trace_export trace.bin trace.json" and open 
+ * trace.json in chrome://tracing or Perfetto.
+ */
+
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+/* Number of events kept, must be a power of 2 and at most 128 */
+#ifndef TRACE_SIZE
+#define TRACE_SIZE 32
+#endif
+
+#if TRACE_SIZE > 128 || (TRACE_SIZE & (TRACE_SIZE - 1)) != 0
+#error "TRACE_SIZE must be a power of 2 and at most 128"
+#endif
+
+/* Event times are 16-bit timer ticks, which wrap every 2.1 s, so a 
+ * wait that records nothing else records TRACE_WAIT at least this 
+ * often for the exporter to follow the time (see TRACE_WAIT_MARK) */
+#define TRACE_WAIT_TICKS 0x4000
+
+/* Kinds of event. For TRACE_BEGIN and TRACE_END arg is a task id 
+ * (the PROFILE_* ids in profile.h), for TRACE_PHASE the new phase, for
+ * TRACE_IR_SEND and TRACE_IR_RECEIVE the byte, and for TRACE_SHOT the
+ * reply to the opponent's shot. TRACE_WAIT only marks the time. */
+#define TRACE_BEGIN 1
+#define TRACE_END 2
+#define TRACE_PHASE 3
+#define TRACE_IR_SEND 4
+#define TRACE_IR_RECEIVE 5
+#define TRACE_SHOT 6
+#define TRACE_WAIT 7
+
+
+
+/* One event, 4 bytes */
+typedef struct traceEvent_s
+{
+    uint8_t kind;
+    uint8_t arg;
+    uint16_t time;  /* Timer 1 ticks, wraps around */
+
+} TraceEvent;
+
+
+
+/* The ring buffer. Once full, the oldest event is at events[next]. */
+typedef struct traceBuffer_s
+{
+    uint8_t next;
+    uint8_t isFull;
+    TraceEvent events[TRACE_SIZE];
+
+} TraceBuffer;
+
+
+
+#ifdef TRACE
+#define TRACE_EVENT(KIND, ARG) traceRecord((KIND), (ARG))
+#define TRACE_WAIT_MARK() traceWaitMark()
+
+extern TraceBuffer traceBuffer;
+
+
+
+void traceRecord(uint8_t kind, uint8_t arg);
+/* Adds an event to the trace, overwriting the oldest event if it is full. */
+
+
+
+void traceWaitMark(void);
+/* Records TRACE_WAIT if nothing has been recorded for TRACE_WAIT_TICKS.
+ * Call often from loops that wait without recording anything. */
+
+#else
+#define TRACE_EVENT(KIND, ARG)
+#define TRACE_WAIT_MARK()
+#endif
+
+#endif /* TRACE_H */
@@ -0,0 +1,149 @@
+/** FILE: trace_export.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: Host program that converts a dump of the trace buffer
+ * (see trace.h) into Chrome trace event JSON, which can be opened in
+ * chrome://tracing or Perfetto. Tasks are shown as spans on one row,
+ * phases as spans on a second row, and IR bytes and shot results as
+ * instant events on a third. The buffer size is taken from the dump, 
+ * so it works for any TRACE_SIZE.
+ *
+ * Usage: trace_export [-r timerRate] trace.bin trace.json
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "trace.h"
+#include "profile.h"
+
+#define DEFAULT_TIMER_RATE 31250.0
+
+/* Sizes as laid out by avr-gcc (no padding, little endian) */
+#define EVENT_BYTES 4
+#define HEADER_BYTES 2
+#define MAX_EVENTS 128
+#define MAX_DUMP_BYTES (HEADER_BYTES + MAX_EVENTS * EVENT_BYTES)
+
+/* Rows of the timeline */
+#define ROW_TASKS 1
+#define ROW_PHASES 2
+#define ROW_LINK 3
+
+
+
+static const char* taskNames[PROFILE_NUM_IDS] = PROFILE_NAMES;
+static const char* phaseNames[] = {"placement", "fire", "waiting", "end", "resync"};
+
+
+
+static void eventPrint(FILE* file, bool* isFirst, const char* name, char type, double microseconds, int row)
+/* Writes one trace event object, without a closing brace so that
+ * arguments can be added. */
+{
+    fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.1f,\"pid\":1,\"tid\":%d",
+            *isFirst ? "" : ",", name, type, microseconds, row);
+    *isFirst = false;
+}
+
+
+
+int main(int argc, char* argv[])
+{
+    uint8_t dump[MAX_DUMP_BYTES + 1];
+    size_t dumpBytes = 0;
+    int size = 0;
+    double timerRate = DEFAULT_TIMER_RATE;
+    double ticks = 0;
+    uint16_t lastTime = 0;
+    bool isFirst = true;
+    bool isPhaseOpen = false;
+    int numEvents = 0;
+    int first = 0;
+    int i = 0;
+    int option = 0;
+    FILE* file = 0;
+
+    while ((option = getopt(argc, argv, "r:")) != -1) {
+        if (option == 'r') {
+            timerRate = strtod(optarg, 0);
+        }
+    }
+    if (optind != argc - 2) {
+        fprintf(stderr, "usage: %s [-r timerRate] trace.bin trace.json\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    file = fopen(argv[optind], "rb");
+    if (file == 0) {
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+    }
+    dumpBytes = fread(dump, 1, sizeof(dump), file);
+    fclose(file);
+    size = (int) (dumpBytes - HEADER_BYTES) / EVENT_BYTES;
+    if (dumpBytes < HEADER_BYTES + EVENT_BYTES || dumpBytes > MAX_DUMP_BYTES
+            || (dumpBytes - HEADER_BYTES) % EVENT_BYTES != 0 || (size & (size - 1)) != 0) {
+        fprintf(stderr, "%s: expected a trace dump of 2 + 4 * TRACE_SIZE bytes, "
+                "with TRACE_SIZE a power of 2 up to %d\n", argv[optind], MAX_EVENTS);
+        return EXIT_FAILURE;
+    }
+
+    /* Oldest event first */
+    if (dump[1]) {
+        numEvents = size;
+        first = dump[0];
+    } else {
+        numEvents = dump[0];
+        first = 0;
+    }
+
+    file = fopen(argv[optind + 1], "w");
+    if (file == 0) {
+        perror(argv[optind + 1]);
+        return EXIT_FAILURE;
+    }
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for (i = 0; i < numEvents; i++) {
+        const uint8_t* event = &dump[HEADER_BYTES + ((first + i) % size) * EVENT_BYTES];
+        uint8_t kind = event[0];
+        uint8_t arg = event[1];
+        uint16_t time = event[2] | (event[3] << 8);
+        double microseconds = 0;
+
+        /* The timer wraps every 2.1 s. Tasks record several events every
+         * few ms and waits that run no tasks record TRACE_WAIT at least 
+         * every half wrap, so consecutive events are never a wrap apart */
+        if (i > 0) {
+            ticks += (uint16_t) (time - lastTime);
+        }
+        lastTime = time;
+        microseconds = ticks * 1e6 / timerRate;
+
+        if ((kind == TRACE_BEGIN || kind == TRACE_END) && arg < PROFILE_NUM_IDS) {
+            eventPrint(file, &isFirst, taskNames[arg], kind == TRACE_BEGIN ? 'B' : 'E', microseconds, ROW_TASKS);
+            fprintf(file, "}");
+        } else if (kind == TRACE_PHASE && arg < sizeof(phaseNames) / sizeof(phaseNames[0])) {
+            if (isPhaseOpen) {
+                eventPrint(file, &isFirst, "", 'E', microseconds, ROW_PHASES);
+                fprintf(file, "}");
+            }
+            eventPrint(file, &isFirst, phaseNames[arg], 'B', microseconds, ROW_PHASES);
+            fprintf(file, "}");
+            isPhaseOpen = true;
+        } else if (kind == TRACE_WAIT) {
+            eventPrint(file, &isFirst, "waiting", 'i', microseconds, ROW_LINK);
+            fprintf(file, ",\"s\":\"t\"}");
+        } else if (kind == TRACE_IR_SEND || kind == TRACE_IR_RECEIVE || kind == TRACE_SHOT) {
+            eventPrint(file, &isFirst, kind == TRACE_IR_SEND ? "IR send" : kind == TRACE_IR_RECEIVE ? "IR receive" : "shot",
+                       'i', microseconds, ROW_LINK);
+            fprintf(file, ",\"s\":\"t\",\"args\":{\"byte\":%u}}", arg);
+        }
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    return EXIT_SUCCESS;
+}
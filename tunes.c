@@ -0,0 +1,80 @@
+/** FILE: tunes.c
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: The tunes used by the game, stored in flash. See
+ * melody.h for how to write your own tunes.
+ */
+
+#include "tunes.h"
+#include "melody.h"
+#include "flash.h"
+
+#define THEME_BPM 200
+#define JINGLE_BPM 400
+
+/* Shorthand for a one beat note in the 4th octave */
+#define N(NAME) MELODY_NOTE(NOTE_##NAME, 4, 1)
+
+
+
+const uint8_t themeTune[] PROGMEM =
+{
+    MELODY_TEMPO(THEME_BPM),
+    N(C), N(C), N(G), N(C), N(GS), N(C), N(C), N(F),
+    N(C), N(G), N(C), N(GS), N(C), N(C), N(F), N(G),
+    N(C), N(C), N(G), N(C), N(GS), N(C), N(C), N(AS),
+    N(C), N(GS), N(C), N(G), N(C), N(C), N(G), N(GS),
+    N(F), N(F), N(GS), N(F), N(F), N(GS), N(F), N(GS),
+    N(F), N(F), N(G), N(F), N(F), N(G), N(F), N(G),
+    N(DS), N(DS), N(G), N(DS), N(AS), N(DS), N(GS), N(G),
+    N(D), N(D), N(G), N(D), N(GS), N(D), N(G), N(F),
+    MELODY_LOOP
+};
+
+
+
+const uint8_t hitTune[] PROGMEM =
+{
+    MELODY_TEMPO(JINGLE_BPM),
+    MELODY_NOTE(NOTE_G, 5, 1), MELODY_NOTE(NOTE_C, 6, 2),
+    MELODY_END
+};
+
+
+
+const uint8_t missTune[] PROGMEM =
+{
+    MELODY_TEMPO(JINGLE_BPM),
+    MELODY_NOTE(NOTE_E, 3, 1), MELODY_NOTE(NOTE_C, 3, 2),
+    MELODY_END
+};
+
+
+
+const uint8_t sunkTune[] PROGMEM =
+{
+    MELODY_TEMPO(JINGLE_BPM),
+    MELODY_NOTE(NOTE_G, 5, 1), MELODY_NOTE(NOTE_C, 6, 1), MELODY_NOTE(NOTE_G, 5, 1),
+    MELODY_NOTE(NOTE_C, 5, 2),
+    MELODY_END
+};
+
+
+
+const uint8_t winTune[] PROGMEM =
+{
+    MELODY_TEMPO(JINGLE_BPM),
+    MELODY_NOTE(NOTE_C, 5, 1), MELODY_NOTE(NOTE_E, 5, 1), MELODY_NOTE(NOTE_G, 5, 1),
+    MELODY_NOTE(NOTE_C, 6, 4), MELODY_REST(4),
+    MELODY_END
+};
+
+
+
+const uint8_t loseTune[] PROGMEM =
+{
+    MELODY_TEMPO(JINGLE_BPM),
+    MELODY_NOTE(NOTE_G, 4, 2), MELODY_NOTE(NOTE_FS, 4, 2), MELODY_NOTE(NOTE_F, 4, 2),
+    MELODY_NOTE(NOTE_E, 4, 4), MELODY_REST(4),
+    MELODY_END
+};
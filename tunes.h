@@ -0,0 +1,25 @@
+/** FILE: tunes.h
+ * AUTHORS: Daniel Watt and Sheldon Zhang
+ * DATE: 16/10/2018
+ * DESCRIPTION: The tunes used by the game, stored in flash. See
+ * melody.h for how to write your own tunes.
+ */
+
+
+#ifndef TUNES_H
+#define TUNES_H
+
+#include <stdint.h>
+
+
+/* Background music, loops forever */
+extern const uint8_t themeTune[];
+
+/* Jingles, each played once */
+extern const uint8_t hitTune[];
+extern const uint8_t missTune[];
+extern const uint8_t sunkTune[];
+extern const uint8_t winTune[];
+extern const uint8_t loseTune[];
+
+#endif /* TUNES_H */